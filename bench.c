@@ -0,0 +1,570 @@
+/**************************************************************************************
+Project Name: Concurrent Epoll Linux Server - Load Generator
+Project Description:
+	Opens many concurrent rembash sessions against a local server using the same
+	handshake as the client and drives a scripted workload through each shell.
+	Reports the connection rate, relayed throughput and the echo latency
+	distribution so changes to the event loop and the thread pool can be measured
+	repeatably on loopback. Every session connects at once and the handshakes run
+	concurrently, so the connection rate reflects the server under an accept storm.
+
+Workloads:
+	echo	Puts each remote terminal in raw mode under cat and times single byte
+			keystroke round trips (-n round trips per session).
+	cat		Streams -n megabytes of output from each shell.
+	yes		Streams -n lines of "yes" output from each shell.
+	secret	Sends well formed and malformed secret lines, one connection each, and
+			checks the server accepts exactly the well formed ones.
+**************************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "rembash.h"
+
+#define BENCH_BATCH 256
+#define BENCH_BUFF 65536
+#define HIST_SUB_BITS 6
+#define HIST_SUB_COUNT (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS (64 * HIST_SUB_COUNT)
+#define ECHO_PROBE 'x'
+#define SYNC_MARKER "READY"
+#define DONE_MARKER "DONE"
+#define REPLY_MAX 64
+
+typedef enum {WORK_ECHO, WORK_CAT, WORK_YES, WORK_SECRET} Workload;
+typedef enum {PHASE_GREET, PHASE_SECRET, PHASE_OPEN, PHASE_SYNC, PHASE_RUN, PHASE_DONE} Phase;
+
+//Log Linear Histogram, Each Power Of Two Split Into HIST_SUB_COUNT Linear Steps
+typedef struct histogram_t{
+	uint64_t counts[HIST_BUCKETS];
+	uint64_t total;
+	uint64_t max;
+} Histogram;
+
+typedef struct bench_session_t{
+	int sockfd;
+	Phase phase;
+	size_t matched;		//Marker Prefix Seen So Far Across Reads
+	uint64_t remaining;	//Echo Round Trips Left
+	uint64_t sent_at;	//Nanosecond Timestamp Of The Outstanding Probe
+	uint64_t received;
+	char line[REPLY_MAX];	//Handshake Line Accumulated Across Reads
+	size_t line_length;
+} Bench_Session;
+
+//One Secret Line And Whether A Correct Server Lets It In
+typedef struct secret_check_t{
+	const char *line;
+	int accepted;	//Any <ok...> Reply, Servers May Decline A Feature And Still Accept
+} Secret_Check;
+
+//Function Prototypes
+int open_sessions(char *address);
+int handle_handshake(Bench_Session *session);
+int check_secrets(char *address);
+int read_reply(int sockfd, char *buffer, size_t size);
+int start_workload(Bench_Session *session);
+int handle_output(Bench_Session *session, char *buffer, ssize_t count);
+int send_probe(Bench_Session *session);
+int scan_marker(Bench_Session *session, const char *marker, char *buffer, ssize_t count, ssize_t *used);
+void finish_session(Bench_Session *session, int failed);
+void run_workload();
+void report();
+void hist_record(Histogram *hist, uint64_t value);
+uint64_t hist_percentile(Histogram *hist, double percentile);
+uint64_t now_ns();
+
+//Instance Variables
+Bench_Session *sessions;
+Histogram echo_latency;
+Workload workload = WORK_ECHO;
+int session_count = 100;
+uint64_t amount = 0;	//Zero Picks The Workload's Default
+int epoll_fd;
+int active;
+int opened;
+int failures;
+uint64_t connect_ns;
+uint64_t run_ns;
+
+//Anything After The Secret Must Be +word Tokens, So Near Misses Get <error>
+const Secret_Check secret_checks[] = {
+	{"<" SECRET ">\n", 1},
+	{"<" SECRET "+zstd>\n", 1},
+	{"<" SECRET "+foo>\n", 1},
+	{"<" SECRET "X>\n", 0},
+	{"<" SECRET "foo>\n", 0},
+	{"<" SECRET "foo+zstd>\n", 0},
+	{"<" SECRET "++zstd>\n", 0},
+	{"<" SECRET "+>\n", 0},
+	{"<" SECRET ">>\n", 0},
+	{"<cs407rembas>\n", 0},
+};
+
+
+int main(int argc, char *argv[]){
+	int option;
+
+	//Parse Command Line Options
+	while((option = getopt(argc, argv, "c:n:w:")) != -1){
+		switch(option){
+			case 'c':	//Concurrent Sessions
+				session_count = atoi(optarg);
+				break;
+			case 'n':	//Round Trips, Megabytes Or Lines Depending On The Workload
+				amount = strtoull(optarg, NULL, 10);
+				break;
+			case 'w':
+				if(strcmp(optarg, "cat") == 0){
+					workload = WORK_CAT;
+				}else if(strcmp(optarg, "yes") == 0){
+					workload = WORK_YES;
+				}else if(strcmp(optarg, "secret") == 0){
+					workload = WORK_SECRET;
+				}else{
+					workload = WORK_ECHO;
+				}
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-c sessions] [-w echo|cat|yes|secret] [-n amount] address\n", argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+	if(optind != argc - 1 || session_count <= 0){
+		fprintf(stderr, "Usage: %s [-c sessions] [-w echo|cat|yes|secret] [-n amount] address\n", argv[0]);
+		exit(EXIT_FAILURE);
+	}
+	if(amount == 0){
+		amount = workload == WORK_ECHO ? 100 : workload == WORK_CAT ? 4 : 100000;
+	}
+
+	//Sessions Closed By The Server Must Not Kill The Generator
+	signal(SIGPIPE, SIG_IGN);
+
+	//The Secret Check Is A Conformance Pass, Not A Load
+	if(workload == WORK_SECRET){
+		exit(check_secrets(argv[optind]) == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	//Thousands Of Sessions Need More Than The Default Descriptor Limit
+	struct rlimit limit;
+	if(getrlimit(RLIMIT_NOFILE, &limit) == 0){
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+
+	if((sessions = calloc(session_count, sizeof(Bench_Session))) == NULL ||
+	   (epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == -1){
+		perror("\nIn Function (Main), Failed To Allocate Sessions. NOTE: This Error"
+			   " Terminates The Benchmark.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	//Connection Rate Covers Connect Plus The Full Rembash Handshake
+	if(open_sessions(argv[optind]) == -1){
+		perror("\nIn Function (Main), Failed To Open Sessions. NOTE: This Error"
+			   " Terminates The Benchmark.\n");
+		exit(EXIT_FAILURE);
+	}
+	run_workload();
+	report();
+	exit(failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+int open_sessions(char *address){
+	struct sockaddr_in server;
+	struct epoll_event ev, evlist[BENCH_BATCH];
+	int pending = session_count, ready, result;
+	uint64_t start = now_ns(), last_ok = start;
+
+	memset(&server, 0, sizeof(server));
+	server.sin_family = AF_INET;
+	server.sin_addr.s_addr = inet_addr(address);
+	server.sin_port = htons(PORT);
+	active = session_count;
+
+	//Every Connect Is Issued Before Any Handshake Completes, So The Server Sees One Storm
+	for(int index = 0; index < session_count; index++){
+		Bench_Session *session = &sessions[index];
+
+		session->phase = PHASE_GREET;
+		if((session->sockfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0)) == -1 ||
+		   (connect(session->sockfd, (struct sockaddr *) &server, sizeof(server)) == -1 && errno != EINPROGRESS)){
+			finish_session(session, 1);
+			pending--;
+			continue;
+		}
+		ev.events = EPOLLIN;
+		ev.data.ptr = session;
+		if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, session->sockfd, &ev) == -1){
+			perror("\nIn Function (open_sessions), Error Adding Session To Epoll Unit."
+				   " NOTE: This Error Exits The Corresponding Function.\n");
+			return -1;
+		}
+	}
+
+	//Handshakes Run Interleaved From The Same Epoll Unit, Timed From First Connect To Last <ok>
+	while(pending > 0){
+		if((ready = epoll_wait(epoll_fd, evlist, BENCH_BATCH, -1)) == -1){
+			if(errno == EINTR){
+				continue;
+			}
+			perror("\nIn Function (open_sessions), Epoll Wait Failed. NOTE: This Error"
+				   " Exits The Corresponding Function.\n");
+			return -1;
+		}
+		for(int i = 0; i < ready; i++){
+			Bench_Session *session = evlist[i].data.ptr;
+
+			if((result = handle_handshake(session)) == 0){
+				continue;
+			}
+			pending--;
+			if(result == -1){
+				finish_session(session, 1);
+				continue;
+			}
+
+			//Open Sessions Stay Quiet Until Their Workload Starts
+			last_ok = now_ns();
+			opened++;
+			session->phase = PHASE_OPEN;
+			ev.events = 0;
+			ev.data.ptr = session;
+			epoll_ctl(epoll_fd, EPOLL_CTL_MOD, session->sockfd, &ev);
+		}
+	}
+	connect_ns = last_ok - start;
+	return 0;
+}
+
+
+int handle_handshake(Bench_Session *session){
+	const char * const secret_message = "<" SECRET ">\n";
+	size_t length = strlen(secret_message);
+	char *end = session->line + session->line_length, *newline;
+	ssize_t count;
+
+	//Peek First So Shell Output Sent Right Behind <ok> Stays Queued For The Workload
+	if((count = recv(session->sockfd, end, REPLY_MAX - 1 - session->line_length, MSG_PEEK)) <= 0){
+		return count < 0 && errno == EAGAIN ? 0 : -1;
+	}
+	if((newline = memchr(end, '\n', count)) != NULL){
+		count = newline - end + 1;
+	}
+	if(recv(session->sockfd, end, count, 0) != count){
+		return -1;
+	}
+	session->line_length += count;
+	if(newline == NULL){
+		return session->line_length < REPLY_MAX - 1 ? 0 : -1;
+	}
+	session->line[session->line_length] = '\0';
+	session->line_length = 0;
+
+	//The Server Speaks First, Then Answers The Secret With <ok>, Or <busy> While Shedding Load
+	if(session->phase == PHASE_GREET){
+		count = write(session->sockfd, secret_message, length);
+		if(strcmp(session->line, "<rembash>\n") != 0 || count == -1 || (size_t) count < length){
+			return -1;
+		}
+		session->phase = PHASE_SECRET;
+		return 0;
+	}
+	return strcmp(session->line, "<ok>\n") == 0 ? 1 : -1;
+}
+
+
+int check_secrets(char *address){
+	char reply[REPLY_MAX];
+	int sockfd, failed = 0;
+
+	for(size_t index = 0; index < sizeof(secret_checks) / sizeof(secret_checks[0]); index++){
+		const Secret_Check *check = &secret_checks[index];
+		size_t length = strlen(check->line);
+
+		if((sockfd = setup_socket(address)) == -1){
+			return -1;
+		}
+
+		//The Server Speaks First, Then Answers The Secret With One Line
+		if(read_reply(sockfd, reply, sizeof(reply)) == -1 || strcmp(reply, "<rembash>\n") != 0 ||
+		   write(sockfd, check->line, length) < (ssize_t) length ||
+		   read_reply(sockfd, reply, sizeof(reply)) == -1){
+			strcpy(reply, "(none)\n");
+		}
+		close(sockfd);
+
+		//Rejections Must Be <error>, Not Just Anything Other Than <ok>
+		int passed = check->accepted ? strncmp(reply, "<ok", 3) == 0 : strcmp(reply, "<error>\n") == 0;
+		failed += !passed;
+		printf("%-6s %.*s -> %s", passed ? "pass" : "FAIL", (int) length - 1, check->line, reply);
+	}
+	return failed;
+}
+
+
+int read_reply(int sockfd, char *buffer, size_t size){
+	size_t length = 0;
+
+	//Byte At A Time So Nothing Past The Line Is Consumed
+	while(length < size - 1 && read(sockfd, buffer + length, 1) == 1){
+		if(buffer[length++] == '\n'){
+			buffer[length] = '\0';
+			return 0;
+		}
+	}
+	return -1;
+}
+
+
+int start_workload(Bench_Session *session){
+	char command[256];
+
+	//Quoted Markers Keep The Echoed Command Line From Matching
+	switch(workload){
+		case WORK_ECHO:	//Raw Mode Cat Turns Every Keystroke Into One Echoed Byte
+			snprintf(command, sizeof(command), "stty raw -echo; echo RE''ADY; exec cat\n");
+			session->phase = PHASE_SYNC;
+			session->remaining = amount;
+			break;
+		case WORK_CAT:
+			snprintf(command, sizeof(command), "stty -echo; head -c %llu /dev/zero | tr '\\0' a;"
+					 " echo DO''NE\n", (unsigned long long) amount << 20);
+			session->phase = PHASE_RUN;
+			break;
+		case WORK_YES:
+			snprintf(command, sizeof(command), "stty -echo; yes | head -n %llu; echo DO''NE\n",
+					 (unsigned long long) amount);
+			session->phase = PHASE_RUN;
+			break;
+		default:
+			return -1;
+	}
+	if(write(session->sockfd, command, strlen(command)) < (ssize_t) strlen(command)){
+		perror("\nIn Function (start_workload), Error Sending Workload Command."
+			   " NOTE: This Error Exits The Corresponding Function.\n");
+		return -1;
+	}
+	return 0;
+}
+
+
+void run_workload(){
+	struct epoll_event evlist[BENCH_BATCH];
+	char *buffer;
+	ssize_t count;
+	int ready;
+
+	if((buffer = malloc(BENCH_BUFF)) == NULL){
+		perror("\nIn Function (run_workload), Error Allocating Read Buffer."
+			   " NOTE: This Error Terminates The Benchmark.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	uint64_t start = now_ns();
+	for(int index = 0; index < session_count; index++){
+		Bench_Session *session = &sessions[index];
+		struct epoll_event ev = {.events = EPOLLIN, .data.ptr = session};
+
+		//Sessions That Failed Their Handshake Are Already Done
+		if(session->phase == PHASE_OPEN &&
+		   (start_workload(session) == -1 || epoll_ctl(epoll_fd, EPOLL_CTL_MOD, session->sockfd, &ev) == -1)){
+			finish_session(session, 1);
+		}
+	}
+
+	//Loop Until Every Session Finished Or Failed
+	while(active > 0){
+		if((ready = epoll_wait(epoll_fd, evlist, BENCH_BATCH, -1)) == -1){
+			if(errno == EINTR){
+				continue;
+			}
+			perror("\nIn Function (run_workload), Epoll Wait Failed. NOTE: This Error"
+				   " Terminates The Benchmark.\n");
+			exit(EXIT_FAILURE);
+		}
+		for(int i = 0; i < ready; i++){
+			Bench_Session *session = evlist[i].data.ptr;
+
+			while(session->phase != PHASE_DONE && (count = read(session->sockfd, buffer, BENCH_BUFF)) != 0){
+				if(count < 0){
+					if(errno != EAGAIN){
+						finish_session(session, 1);
+					}
+					break;
+				}
+				if(handle_output(session, buffer, count) == -1){
+					finish_session(session, 1);
+				}
+			}
+
+			//The Server Closed A Session Before Its Workload Completed
+			if(session->phase != PHASE_DONE && count == 0){
+				finish_session(session, 1);
+			}
+		}
+	}
+	run_ns = now_ns() - start;
+	free(buffer);
+}
+
+
+int handle_output(Bench_Session *session, char *buffer, ssize_t count){
+	ssize_t used;
+
+	session->received += count;
+	switch(session->phase){
+		case PHASE_SYNC:	//Wait For The Remote Cat Before Timing Anything
+			if(scan_marker(session, SYNC_MARKER, buffer, count, &used)){
+				session->phase = PHASE_RUN;
+				return send_probe(session);
+			}
+			return 0;
+
+		case PHASE_RUN:
+			if(workload != WORK_ECHO){
+				if(scan_marker(session, DONE_MARKER, buffer, count, &used)){
+					finish_session(session, 0);
+				}
+				return 0;
+			}
+
+			//Each Probe Byte Coming Back Closes One Round Trip
+			if(memchr(buffer, ECHO_PROBE, count) != NULL){
+				hist_record(&echo_latency, now_ns() - session->sent_at);
+				if(--session->remaining == 0){
+					finish_session(session, 0);
+					return 0;
+				}
+				return send_probe(session);
+			}
+			return 0;
+
+		default:
+			return 0;
+	}
+}
+
+
+int send_probe(Bench_Session *session){
+	char probe = ECHO_PROBE;
+
+	session->sent_at = now_ns();
+	if(write(session->sockfd, &probe, sizeof(probe)) != sizeof(probe)){
+		return -1;
+	}
+	return 0;
+}
+
+
+int scan_marker(Bench_Session *session, const char *marker, char *buffer, ssize_t count, ssize_t *used){
+	size_t length = strlen(marker);
+
+	//Markers Have No Repeated Prefix So A Mismatch Only Restarts The Match
+	for(ssize_t index = 0; index < count; index++){
+		if(buffer[index] == marker[session->matched]){
+			session->matched++;
+		}else{
+			session->matched = buffer[index] == marker[0];
+		}
+		if(session->matched == length){
+			session->matched = 0;
+			*used = index + 1;
+			return 1;
+		}
+	}
+	*used = count;
+	return 0;
+}
+
+
+void finish_session(Bench_Session *session, int failed){
+	if(session->phase == PHASE_DONE){
+		return;
+	}
+	session->phase = PHASE_DONE;
+	failures += failed;
+	active--;
+	epoll_ctl(epoll_fd, EPOLL_CTL_DEL, session->sockfd, NULL);
+	close(session->sockfd);
+}
+
+
+void report(){
+	uint64_t bytes = 0;
+
+	for(int index = 0; index < session_count; index++){
+		bytes += sessions[index].received;
+	}
+
+	printf("sessions      %d (%d failed)\n", session_count, failures);
+	printf("connections/s %.1f (%d opened concurrently, first connect to last <ok>)\n",
+		   connect_ns > 0 ? opened / (connect_ns / 1e9) : 0.0, opened);
+	printf("elapsed       %.3f s\n", run_ns / 1e9);
+	printf("throughput    %.2f MB/s (%llu bytes)\n", bytes / (run_ns / 1e9) / (1 << 20),
+		   (unsigned long long) bytes);
+
+	if(workload == WORK_ECHO && echo_latency.total > 0){
+		printf("echo rtt      p50 %.1f us  p99 %.1f us  p999 %.1f us  max %.1f us  (%llu samples)\n",
+			   hist_percentile(&echo_latency, 50.0) / 1e3, hist_percentile(&echo_latency, 99.0) / 1e3,
+			   hist_percentile(&echo_latency, 99.9) / 1e3, echo_latency.max / 1e3,
+			   (unsigned long long) echo_latency.total);
+	}
+}
+
+
+void hist_record(Histogram *hist, uint64_t value){
+	//Values Below 2 * HIST_SUB_COUNT Are Exact, Larger Ones Keep HIST_SUB_BITS Of Precision
+	int msb = 63 - __builtin_clzll(value | 1);
+	int shift = msb > HIST_SUB_BITS ? msb - HIST_SUB_BITS : 0;
+	size_t index = (size_t) shift * HIST_SUB_COUNT + (value >> shift);
+
+	hist->counts[index < HIST_BUCKETS ? index : HIST_BUCKETS - 1]++;
+	hist->total++;
+	if(value > hist->max){
+		hist->max = value;
+	}
+}
+
+
+uint64_t hist_percentile(Histogram *hist, double percentile){
+	uint64_t target = (uint64_t) (hist->total * percentile / 100.0 + 0.5), seen = 0;
+
+	if(target == 0){
+		target = 1;
+	}
+	for(size_t index = 0; index < HIST_BUCKETS; index++){
+		if((seen += hist->counts[index]) >= target){
+			//Report The Upper Edge Of The Bucket Like An HDR Histogram
+			size_t shift = index < 2 * HIST_SUB_COUNT ? 0 : index / HIST_SUB_COUNT - 1;
+			uint64_t low = (uint64_t) (index - shift * HIST_SUB_COUNT) << shift;
+			uint64_t high = low + ((uint64_t) 1 << shift) - 1;
+			return high < hist->max ? high : hist->max;
+		}
+	}
+	return hist->max;
+}
+
+
+uint64_t now_ns(){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000ull + now.tv_nsec;
+}
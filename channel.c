@@ -0,0 +1,259 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include "channel.h"
+
+//Local Function Prototypes
+static void unlist(Channel_Set *set, Channel *channel);
+
+
+Channel_Set *channel_set_create(int node){
+	Channel_Set *set;
+
+	if((set = calloc(1, sizeof(Channel_Set))) == NULL){
+		perror("\nIn Function (channel_set_create), Error Allocating Channel Table."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return NULL;
+	}
+	set->ready_tail = &set->ready;
+	set->node = node;
+	if(mux_output_init(&set->output, MUX_OUTPUT_BYTES) == -1){
+		free(set);
+		return NULL;
+	}
+	return set;
+}
+
+
+void channel_set_destroy(Channel_Set *set){
+	//Callers Close Every Channel First, Each Master Is Unmapped By Its Owner
+	mux_output_destroy(&set->output);
+	free(set);
+}
+
+
+Channel *channel_open(Channel_Set *set, uint16_t id, int master_fd, uint32_t credit){
+	Channel *channel;
+
+	if((channel = calloc(1, sizeof(Channel))) == NULL){
+		perror("\nIn Function (channel_open), Error Allocating Channel."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return NULL;
+	}
+
+	//The Input Ring Holds Exactly The Credit Granted, So A Client Can Never Overrun It
+	if(ring_init(&channel->input, MUX_WINDOW, set->node) == -1){
+		free(channel);
+		return NULL;
+	}
+	channel->master_fd = master_fd;
+	channel->id = id;
+	channel->credit = credit;
+	channel->window = MUX_WINDOW;
+	set->channels[id] = channel;
+	return channel;
+}
+
+
+static void unlist(Channel_Set *set, Channel *channel){
+	Channel **link;
+
+	if(channel->listed == CHANNEL_READY){
+		for(link = &set->ready; *link != channel; link = &(*link)->next);
+		if((*link = channel->next) == NULL){
+			set->ready_tail = link;
+		}
+	}else if(channel->listed == CHANNEL_DEFERRED){
+		for(link = &set->deferred; *link != channel; link = &(*link)->next);
+		*link = channel->next;
+	}
+	if(channel->blocked){
+		for(link = &set->blocked; *link != channel; link = &(*link)->next_blocked);
+		*link = channel->next_blocked;
+	}
+}
+
+
+int channel_close(Channel_Set *set, Channel *channel, int notify){
+	int result = 0;
+
+	//The Client Forgets The Channel Once Its CLOSE Arrives, Nothing Follows It
+	unlist(set, channel);
+	set->channels[channel->id] = NULL;
+	if(notify){
+		result = mux_send(&set->output, MUX_CLOSE, channel->id, 0, NULL);
+	}
+	close(channel->master_fd);
+	ring_destroy(&channel->input);
+	free(channel);
+	return result;
+}
+
+
+Channel *channel_find(Channel_Set *set, int master_fd, uint16_t id){
+	Channel *channel = id < MUX_MAX_CHANNELS ? set->channels[id] : NULL;
+
+	//A Recycled Descriptor May Still Name A Channel That Has Since Closed
+	return channel != NULL && channel->master_fd == master_fd ? channel : NULL;
+}
+
+
+int channel_deliver(Channel_Set *set, Channel *channel, const char *payload, size_t length){
+	char *segment;
+	size_t space;
+
+	//More Than The Credit Granted Breaks The Protocol
+	if(length > channel->window){
+		return -1;
+	}
+	channel->window -= length;
+	while(length > 0){
+		space = ring_reserve(&channel->input, &segment);
+		space = space < length ? space : length;
+		memcpy(segment, payload, space);
+		ring_commit(&channel->input, space);
+		payload += space;
+		length -= space;
+	}
+	channel_ready(set, channel);
+	return 0;
+}
+
+
+void channel_grant(Channel_Set *set, Channel *channel, uint32_t credit){
+	channel->credit += credit;
+	channel_ready(set, channel);
+}
+
+
+void channel_ready(Channel_Set *set, Channel *channel){
+	//A Deferred Channel Already Has Its Next Turn
+	if(channel->listed != CHANNEL_UNLISTED){
+		return;
+	}
+	channel->listed = CHANNEL_READY;
+	channel->next = NULL;
+	*set->ready_tail = channel;
+	set->ready_tail = &channel->next;
+}
+
+
+void channel_block(Channel_Set *set, Channel *channel){
+	if(channel->blocked){
+		return;
+	}
+	channel->blocked = 1;
+	channel->next_blocked = set->blocked;
+	set->blocked = channel;
+}
+
+
+void channel_unblock(Channel_Set *set){
+	Channel *channel;
+
+	//Room In The Output Queue Lets Every Blocked Channel Try Again
+	while((channel = set->blocked) != NULL){
+		set->blocked = channel->next_blocked;
+		channel->blocked = 0;
+		channel_ready(set, channel);
+	}
+}
+
+
+void channel_defer(Channel_Set *set, Channel *channel){
+	if(channel->listed != CHANNEL_UNLISTED){
+		return;
+	}
+	channel->listed = CHANNEL_DEFERRED;
+	channel->next = set->deferred;
+	set->deferred = channel;
+}
+
+
+int channel_requeue(Channel_Set *set){
+	Channel *channel;
+	int requeued = 0;
+
+	while((channel = set->deferred) != NULL){
+		set->deferred = channel->next;
+		channel->listed = CHANNEL_UNLISTED;
+		channel_ready(set, channel);
+		requeued = 1;
+	}
+	return requeued;
+}
+
+
+Channel *channel_next(Channel_Set *set){
+	Channel *channel;
+
+	if((channel = set->ready) == NULL){
+		return NULL;
+	}
+	if((set->ready = channel->next) == NULL){
+		set->ready_tail = &set->ready;
+	}
+	channel->listed = CHANNEL_UNLISTED;
+	return channel;
+}
+
+
+Channel_Status channel_pump(Channel_Set *set, Channel *channel){
+	ssize_t count;
+	size_t space;
+	char *payload;
+
+	//Keystrokes First, The Client Sends More Once The PTY Has Taken A Quarter Window
+	if(ring_used(&channel->input) > 0){
+		if((count = ring_drain(&channel->input, channel->master_fd)) < 0 && errno != EAGAIN){
+			return CHANNEL_CLOSED;
+		}
+		if(count > 0){
+			channel->consumed += count;
+			set->moved_to_pty += count;
+		}
+	}
+	if(channel->consumed >= MUX_WINDOW / 4){
+		if(mux_send(&set->output, MUX_CREDIT, channel->id, channel->consumed, NULL) == -1){
+			return CHANNEL_CLOSED;
+		}
+		channel->window += channel->consumed;
+		channel->consumed = 0;
+	}
+
+	//Output Goes Straight Into DATA Frames While The Client Has Credit And The Queue Room
+	for(int pass = 0; pass < CHANNEL_PASS_LIMIT; pass++){
+		if(channel->credit == 0){
+			return CHANNEL_IDLE;	//The Client's CREDIT Resumes The Channel
+		}
+		payload = mux_reserve(&set->output, &space);
+		if(space < CHANNEL_MIN_READ){
+			return CHANNEL_BLOCKED;
+		}
+		if((count = read(channel->master_fd, payload, space < channel->credit ? space : channel->credit)) <= 0){
+			//The Master Reads EIO Once The Shell Has Exited
+			return count < 0 && errno == EAGAIN ? CHANNEL_IDLE : CHANNEL_CLOSED;
+		}
+		mux_commit(&set->output, channel->id, count);
+		channel->credit -= count;
+		set->moved_to_socket += count;
+	}
+	return CHANNEL_YIELD;
+}
+
+
+uint32_t channel_events(const Channel *channel){
+	uint32_t events = 0;
+
+	//Reads Wait On Credit And Queue Room, Writes On Pending Keystrokes
+	if(channel->credit > 0 && !channel->blocked){
+		events |= EPOLLIN;
+	}
+	if(ring_used(&channel->input) > 0){
+		events |= EPOLLOUT;
+	}
+	return events;
+}
@@ -0,0 +1,61 @@
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ring.h"
+#include "mux.h"
+
+#define CHANNEL_PASS_LIMIT 4	//PTY Reads Per Pump Before Other Channels Get A Turn
+#define CHANNEL_MIN_READ 512	//Less Output Room Than This Leaves A Channel Blocked
+
+typedef enum {CHANNEL_IDLE, CHANNEL_BLOCKED, CHANNEL_YIELD, CHANNEL_CLOSED} Channel_Status;
+typedef enum {CHANNEL_UNLISTED, CHANNEL_READY, CHANNEL_DEFERRED} Channel_List;
+
+//One Shell Multiplexed Over A Shared Connection Declaration
+typedef struct channel_t {
+	int master_fd;
+	uint16_t id;
+	Ring input;			//Keystrokes Within The Credit Granted, Not Yet Written To The PTY
+	size_t credit;		//Output Bytes The Client Still Accepts
+	size_t consumed;	//Input Written To The PTY Since The Last Grant
+	size_t window;		//Input Bytes The Client May Still Send Before Its Next CREDIT
+	uint32_t events;	//Interest Last Armed In Oneshot Mode
+	Channel_List listed;	//On The Ready Or Deferred List
+	int blocked;		//On The Blocked List, Possibly Ready As Well
+	struct channel_t *next;
+	struct channel_t *next_blocked;
+} Channel;
+
+//Every Channel Of A Connection And The Frames Flowing Through It
+typedef struct channel_set_t {
+	Mux_Input input;
+	Mux_Output output;
+	Channel *channels[MUX_MAX_CHANNELS];
+	Channel *ready;		//Channels With Work For The Next Pump, In Arrival Order
+	Channel **ready_tail;
+	Channel *blocked;	//Channels Waiting For Room In The Output Queue
+	Channel *deferred;	//Channels That Used Their Reads, Ready Again After The Pass
+	size_t moved_to_pty;	//Bytes Written By Pumps Since The Caller Last Cleared Them
+	size_t moved_to_socket;
+	int node;			//NUMA Node Channel Input Rings Are Bound To, -1 Unplaced
+} Channel_Set;
+
+//Function Prototypes
+Channel_Set *channel_set_create(int node);
+void channel_set_destroy(Channel_Set *set);
+Channel *channel_open(Channel_Set *set, uint16_t id, int master_fd, uint32_t credit);
+int channel_close(Channel_Set *set, Channel *channel, int notify);
+Channel *channel_find(Channel_Set *set, int master_fd, uint16_t id);
+int channel_deliver(Channel_Set *set, Channel *channel, const char *payload, size_t length);
+void channel_grant(Channel_Set *set, Channel *channel, uint32_t credit);
+void channel_ready(Channel_Set *set, Channel *channel);
+void channel_block(Channel_Set *set, Channel *channel);
+void channel_unblock(Channel_Set *set);
+void channel_defer(Channel_Set *set, Channel *channel);
+int channel_requeue(Channel_Set *set);
+Channel *channel_next(Channel_Set *set);
+Channel_Status channel_pump(Channel_Set *set, Channel *channel);
+uint32_t channel_events(const Channel *channel);
+
+#endif
@@ -9,27 +9,58 @@
 #include <signal.h>
 #include <sys/wait.h>
 #include <termios.h>
-#include "readline.c"
+#include <poll.h>
+#include <errno.h>
+#include "rembash.h"
+#include "codec.h"
+#include "mux.h"
 
 #define MAX_BUFF 4024
-#define PORT 4070
-#define SECRET "cs407rembash"
+
+typedef enum {VIEW_FREE, VIEW_OPENING, VIEW_OPEN} View_State;
+
+//The Client's Side Of One Multiplexed Channel
+typedef struct channel_view_t {
+	View_State state;
+	uint32_t credit;	//Keystrokes The Server Still Accepts
+	uint32_t shown;		//Output Written To The Terminal Since The Last Grant
+	char *held;			//Output Received While The Channel Is In The Background
+	size_t held_length;
+} Channel_View;
+
+static Channel_View views[MUX_MAX_CHANNELS];
 
 //Global Variable to Restablish Terminal Settings
 struct termios saved_attributes;
 
 	//Function Prototypes
 	void sigchild_handler(int sig);
-	int handle_rembash(int sockfd);
-	int setup_socket(char *address);
-	int socket_input(int sockfd);
-	int socket_output(int sockfd);
+	int socket_input(int sockfd, int compressed);
+	int socket_output(int sockfd, int compressed);
+	int compressed_input(int sockfd);
+	int compressed_output(int sockfd);
+	int write_all(int fd, const char *buffer, size_t length);
+	int multiplex(int sockfd);
+	int view_frame(const Mux_Frame *frame, Mux_Output *output, int *active);
+	int view_keys(const char *keys, size_t length, Mux_Output *output, int *active);
+	int open_view(Mux_Output *output);
+	int show_view(int id, Mux_Output *output);
+	int next_view(int id);
 	int start_noncanon();
 	int reset_terminal();
 
 int main(int argc, char *argv[]){
-	//Command Line Argument Validation
-	if(argc != 2){
+	//Command Line Argument Validation, -z Asks For A Compressed Session, -m For Channels
+	int option, compressed = 0, multiplexed = 0;
+	while((option = getopt(argc, argv, "mz")) != -1){
+		if((option != 'm' && option != 'z') || (option == 'm' ? compressed : multiplexed)){
+			fprintf(stderr, "Usage: %s [-m | -z] server_address\n", argv[0]);
+			exit(EXIT_FAILURE);
+		}
+		multiplexed |= option == 'm';
+		compressed |= option == 'z';
+	}
+	if(argc - optind != 1){
 		perror("\nIn Function (Main), Incorrect Number of Arguments. NOTE: This"
 			   " Terminates The Client Program.\n");
 		exit(EXIT_FAILURE);
@@ -38,18 +69,20 @@ int main(int argc, char *argv[]){
 	//Socket Intialization and Connection
 	int sockfd;
 	
-	if((sockfd = setup_socket(argv[1])) == -1){
+	if((sockfd = setup_socket(argv[optind])) == -1){
 		perror("\nIn Function (Main), Error Connecting Client End Of The Socket."
 			   " Note: This Terminates The Client Program.\n");
 		exit(EXIT_FAILURE);
 	}
 	 
-	//Client/Server Initial Communication
-	if(handle_rembash(sockfd) == -1){
+	//Client/Server Initial Communication, Compression Or Channels Only If The Server Agrees
+	int agreed = handle_rembash(sockfd, multiplexed ? MUX_FEATURE : compressed ? "+zstd" : NULL);
+	if(agreed == -1){
 		perror("\nIn Function (Main), Error Completing Rembash Protocol."
 			   " Note: This Terminates The Client Program.\n");
 		exit(EXIT_FAILURE);
 	}
+	compressed = compressed && agreed;
 	
 	//Setting TTY into Noncanonical Mode
 	if(start_noncanon() == -1){
@@ -58,6 +91,17 @@ int main(int argc, char *argv[]){
 		exit(EXIT_FAILURE);
 	}
 	
+	//Channels Share One Process, Which Switches Between Them On Escape Keys
+	if(multiplexed && agreed){
+		int result = multiplex(sockfd);
+		if(reset_terminal() == -1 || result == -1){
+			perror("\nIn Function (Main), Error Running Multiplexed Channels."
+				   " Note: This Terminates The Client Program.\n");
+			exit(EXIT_FAILURE);
+		}
+		exit(EXIT_SUCCESS);
+	}
+	
 	//Set up SIGCHILD Signal for Child Processes Terminating Before Parent 
 	struct sigaction response;
 	memset(&response, 0, sizeof(response));
@@ -70,7 +114,7 @@ int main(int argc, char *argv[]){
 
 	switch(child_pid){
 		case 0:	//Read Commands from Terminal
-			if(socket_input(sockfd) == -1){
+			if(socket_input(sockfd, compressed) == -1){
 				perror("\nIn Function (Main), Could Not Read Characters From User."
 					   " Note: This Terminates The Client Program.\n");
 				exit(EXIT_FAILURE);
@@ -83,7 +127,7 @@ int main(int argc, char *argv[]){
 			exit(EXIT_FAILURE);
 			
 		default: //Output Bash Response to Terminal
-			if(socket_output(sockfd) == -1){
+			if(socket_output(sockfd, compressed) == -1){
 				perror("\nIn Function (Main), Could Not Output Character To Terminal."
 					   " Note: This Terminates The Client Program.\n");
 				exit(EXIT_FAILURE);
@@ -111,36 +155,12 @@ int main(int argc, char *argv[]){
 }
 
 	   
-int setup_socket(char *wanted_address){
-	
-	//Creates and Catches Socket 
-    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+int socket_input(int sockfd, int compressed){
+	char c;
 	
-	if(sockfd < 0){
-		perror("\nIn Function (setup_socket), Error Connecting Client Socket"
-					   " To Wanted Address. Note: Error Exits Function.\n");
-		return -1;
+	if(compressed){
+		return compressed_input(sockfd);
 	}
-	
-	//Address Initialization
-	struct sockaddr_in address;
-    address.sin_family = AF_INET;
-    address.sin_addr.s_addr = inet_addr(wanted_address);
-    address.sin_port = htons(PORT);
-
-	//Connects Socket with Specified Address
-    int connect_result = connect(sockfd, (struct sockaddr *) &address, sizeof(address));
-	if(connect_result == -1){
-        perror("\nIn Function (setup_socket), Error Connecting Client Socket End"
-					   " To The Server. Note: Error Exits Function.\n");
-		return -1;
-    }
-	return sockfd;
-}
-
-
-int socket_input(int sockfd){
-	char c;
     while(read(STDIN_FILENO, &c, sizeof(c))) {
 		if(write(sockfd, &c, sizeof(c)) < 0){
 			perror("\nIn Function (socket_input), Error Writing Characters Read"
@@ -152,7 +172,33 @@ int socket_input(int sockfd){
 }
 
 
-int socket_output(int sockfd){
+int compressed_input(int sockfd){
+	Codec codec;
+	char output[MAX_BUFF];
+	ssize_t produced;
+	
+	if(codec_init(&codec, CODEC_COMPRESS) == -1){
+		return -1;
+	}
+	
+	//Each Batch Of Keystrokes Is Flushed As Its Own Block
+	while(codec_read(&codec, STDIN_FILENO) > 0){
+		do{
+			if((produced = codec_run(&codec, output, sizeof(output))) == -1 ||
+			   write_all(sockfd, output, produced) == -1){
+				perror("\nIn Function (compressed_input), Error Writing Characters Read"
+					   " From User. Note: Error Exits Function.\n");
+				codec_destroy(&codec);
+				return -1;
+			}
+		}while(!codec_idle(&codec));
+	}
+	codec_destroy(&codec);
+	return 0;
+}
+
+
+int socket_output(int sockfd, int compressed){
 	
 	int chars_read;
 	char *read_buffer;
@@ -164,6 +210,11 @@ int socket_output(int sockfd){
 		return -1;
 	}
 	
+	if(compressed){
+		free(read_buffer);
+		return compressed_output(sockfd);
+	}
+	
 	//Read from Socket to STDOUT
 	while((chars_read = read(sockfd, read_buffer, MAX_BUFF)) > 0){
 		if(write(STDOUT_FILENO, read_buffer, chars_read) < chars_read){
@@ -176,44 +227,275 @@ int socket_output(int sockfd){
 }
 	
 
-int handle_rembash(int sockfd){
+int compressed_output(int sockfd){
+	Codec codec;
+	char output[MAX_BUFF];
+	ssize_t produced;
 	
-	const char * const rembash_message = "<rembash>\n";
-	const char * const ok_message = "<ok>\n";
+	if(codec_init(&codec, CODEC_DECOMPRESS) == -1){
+		return -1;
+	}
 	
-	//Rembash Protocol Verification
-	char *message_buffer = readline(sockfd);
+	//One Socket Read May Decode Into Several Terminal Writes
+	while(codec_read(&codec, sockfd) > 0){
+		do{
+			if((produced = codec_run(&codec, output, sizeof(output))) == -1 ||
+			   write_all(STDOUT_FILENO, output, produced) == -1){
+				perror("\nIn Function (compressed_output), Error Writing Characters Read"
+					   " From PTY Master. Note: Error Exits Function.\n");
+				codec_destroy(&codec);
+				return -1;
+			}
+		}while(!codec_idle(&codec));
+	}
+	codec_destroy(&codec);
+	return 0;
+}
+
+
+int write_all(int fd, const char *buffer, size_t length){
+	ssize_t chars_written;
 	
-	if(strcmp(rembash_message, message_buffer) != 0){
-		perror("\nIn Function (handle_rembash), Incorrect Rembash Message."
-			   " Note: Error Exits Function.\n");
-		return -1;
+	//Terminals And Sockets May Take A Large Block In Pieces
+	while(length > 0){
+		if((chars_written = write(fd, buffer, length)) < 0){
+			return -1;
+		}
+		buffer += chars_written;
+		length -= chars_written;
 	}
+	return 0;
+}
+
+
+int multiplex(int sockfd){
+	static Mux_Input input;
+	Mux_Output output;
+	Mux_Frame frame;
+	struct pollfd watched[2];
+	char keys[MAX_BUFF];
+	ssize_t count;
+	int active, parsed = 0, result = 0;
 	
-	//Secret Message Send
-	int secret_length = strlen("<" SECRET ">\n");
-    if(write(sockfd, "<" SECRET ">\n", secret_length) < secret_length){
-		perror("\nIn Function (handle_rembash), Incorrect Secret Message."
-			   " Note: Error Exits Function.\n");
+	//The First Channel Opens With The Connection
+	if(mux_output_init(&output, MUX_OUTPUT_BYTES) == -1 || (active = open_view(&output)) == -1){
 		return -1;
 	}
-    
-	//Checks Secert Message Server Response
-	if((message_buffer = readline(sockfd)) == NULL){
-		perror("\nIn Function (handle_rembash), Error Reading From Socket"
-			   " Note: Error Exits Function.\n");
+	while(result == 0 && mux_flush(&output, sockfd) == 0){
+		//Keys Are Only Read While The Active Channel Can Take Them
+		watched[0].fd = STDIN_FILENO;
+		watched[0].events = views[active].state == VIEW_OPEN && views[active].credit > 0 ? POLLIN : 0;
+		watched[1].fd = sockfd;
+		watched[1].events = POLLIN;
+		if(poll(watched, 2, -1) == -1){
+			if(errno == EINTR){
+				continue;
+			}
+			result = -1;
+			break;
+		}
+		
+		//Frames From The Server, A Closed Connection Ends The Client
+		if(watched[1].revents){
+			if((count = mux_fill(&input, sockfd)) <= 0){
+				break;
+			}
+			while(result == 0 && (parsed = mux_next(&input, &frame)) == 1){
+				result = view_frame(&frame, &output, &active);
+			}
+			if(parsed == -1){
+				fprintf(stderr, "\nIn Function (multiplex), Malformed Frame From The Server."
+						" Note: Error Exits Function.\n");
+				result = -1;
+			}
+		}
+		
+		//Keystrokes For The Active Channel Or A Channel Command
+		if(result == 0 && (watched[0].revents & POLLIN)){
+			size_t limit = views[active].credit < sizeof(keys) ? views[active].credit : sizeof(keys);
+			if((count = read(STDIN_FILENO, keys, limit)) <= 0){
+				break;
+			}
+			result = view_keys(keys, count, &output, &active);
+		}
+	}
+	mux_output_destroy(&output);
+	return result == -1 ? -1 : 0;
+}
+
+
+int view_frame(const Mux_Frame *frame, Mux_Output *output, int *active){
+	Channel_View *view = &views[frame->channel];
+	
+	//Returns One Once The Last Channel Has Closed
+	switch(frame->type){
+		case MUX_OPEN:
+			if(view->state == VIEW_OPENING){
+				view->state = VIEW_OPEN;
+				view->credit = frame->value;
+			}
+			return 0;
+			
+		case MUX_DATA:
+			if(view->state != VIEW_OPEN){
+				return 0;
+			}
+			
+			//Background Output Waits Within Its Window, The Server Stops When It Is Spent
+			if(frame->channel != *active){
+				if(view->held_length + frame->value > MUX_WINDOW){
+					return -1;
+				}
+				memcpy(view->held + view->held_length, frame->payload, frame->value);
+				view->held_length += frame->value;
+				return 0;
+			}
+			if(write_all(STDOUT_FILENO, frame->payload, frame->value) == -1){
+				return -1;
+			}
+			
+			//Credit Returns A Quarter Window At A Time Once The Terminal Has Taken It
+			if((view->shown += frame->value) >= MUX_WINDOW / 4){
+				if(mux_send(output, MUX_CREDIT, frame->channel, view->shown, NULL) == -1){
+					return -1;
+				}
+				view->shown = 0;
+			}
+			return 0;
+			
+		case MUX_CREDIT:
+			view->credit += frame->value;
+			return 0;
+			
+		case MUX_CLOSE:
+			if(view->state == VIEW_FREE){
+				return 0;
+			}
+			free(view->held);
+			memset(view, 0, sizeof(*view));
+			fprintf(stderr, "\r\n[channel %d closed]\r\n", frame->channel);
+			if(frame->channel != *active){
+				return 0;
+			}
+			if((*active = next_view(frame->channel)) == -1){
+				return 1;
+			}
+			return show_view(*active, output);
+	}
+	return 0;
+}
+
+
+int view_keys(const char *keys, size_t length, Mux_Output *output, int *active){
+	static int escaped;
+	size_t start = 0, index;
+	int id;
+	
+	//Ctrl-] c Opens A Channel, Ctrl-] n Shows The Next, Ctrl-] x Closes This One
+	for(index = 0; index < length; index++){
+		if(!escaped && keys[index] != MUX_ESCAPE){
+			continue;
+		}
+		if(index > start && mux_send(output, MUX_DATA, *active, index - start, keys + start) == -1){
+			return -1;
+		}
+		views[*active].credit -= index - start;
+		start = index + 1;
+		if(!escaped){
+			escaped = 1;
+			continue;
+		}
+		escaped = 0;
+		
+		//Ctrl-] Twice Sends One, Other Commands Drop The Rest Of The Read With The Switch
+		switch(keys[index]){
+			case MUX_ESCAPE:
+				start = index;
+				continue;
+				
+			case 'c':
+				if((id = open_view(output)) == -1){
+					return 0;
+				}
+				*active = id;
+				fprintf(stderr, "\r\n[channel %d]\r\n", id);
+				return 0;
+				
+			case 'n':
+				if((id = next_view(*active)) != -1 && id != *active){
+					*active = id;
+					return show_view(id, output);
+				}
+				return 0;
+				
+			case 'x':
+				return mux_send(output, MUX_CLOSE, *active, 0, NULL);
+		}
+	}
+	if(index > start && mux_send(output, MUX_DATA, *active, index - start, keys + start) == -1){
 		return -1;
 	}
+	views[*active].credit -= index - start;
+	return 0;
+}
+
+
+int open_view(Mux_Output *output){
+	//Channel Numbers Are Reused Once The Server Has Confirmed Their Close
+	for(int id = 0; id < MUX_MAX_CHANNELS; id++){
+		if(views[id].state != VIEW_FREE){
+			continue;
+		}
+		if((views[id].held = malloc(MUX_WINDOW)) == NULL){
+			perror("\nIn Function (open_view), Error Allocating Channel Output Buffer."
+				   " Note: Error Exits Function.\n");
+			return -1;
+		}
+		if(mux_send(output, MUX_OPEN, id, MUX_WINDOW, NULL) == -1){
+			free(views[id].held);
+			views[id].held = NULL;
+			return -1;
+		}
+		views[id].state = VIEW_OPENING;
+		return id;
+	}
+	fprintf(stderr, "\r\n[no free channel]\r\n");
+	return -1;
+}
+
+
+int show_view(int id, Mux_Output *output){
+	Channel_View *view = &views[id];
 	
-    if(strcmp(ok_message, message_buffer) != 0){
-		perror("\nIn Function (handle_rembash), Could Not Send OK Message"
-			   " Note: Error Exits Function.\n");
+	//Output Held In The Background Is Shown At Once And Its Credit Returned
+	fprintf(stderr, "\r\n[channel %d]\r\n", id);
+	if(write_all(STDOUT_FILENO, view->held, view->held_length) == -1){
 		return -1;
 	}
+	view->shown += view->held_length;
+	view->held_length = 0;
+	if(view->shown > 0){
+		if(mux_send(output, MUX_CREDIT, id, view->shown, NULL) == -1){
+			return -1;
+		}
+		view->shown = 0;
+	}
 	return 0;
 }
 
 
+int next_view(int id){
+	//Cycles Through Open Channels After The Given One, -1 Once None Is Left
+	for(int step = 1; step <= MUX_MAX_CHANNELS; step++){
+		int candidate = (id + step) % MUX_MAX_CHANNELS;
+		if(views[candidate].state != VIEW_FREE){
+			return candidate;
+		}
+	}
+	return -1;
+}
+
+
 int start_noncanon(){
 	
 	//Store Noncanonical Mode Attributes
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include "codec.h"
+
+//Levels Climb While The Socket Backs Up, Trading CPU For Bandwidth
+static const int codec_levels[] = {1, 3, 6};
+#define CODEC_STEPS ((int) (sizeof(codec_levels) / sizeof(codec_levels[0])))
+
+
+int codec_init(Codec *codec, Codec_Mode mode){
+	codec->mode = mode;
+	codec->compressor = NULL;
+	codec->decompressor = NULL;
+	codec->input_length = codec->input_used = 0;
+	codec->unflushed = 0;
+	codec->step = 0;
+	codec->end_frame = 0;
+
+	if((codec->input = malloc(CODEC_INPUT_BYTES)) == NULL){
+		perror("\nIn Function (codec_init), Error Allocating Compression Input Buffer."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+
+	//Each Direction Keeps Its Own Stream So History Spans The Whole Session
+	if(mode == CODEC_COMPRESS){
+		if((codec->compressor = ZSTD_createCCtx()) == NULL){
+			perror("\nIn Function (codec_init), Error Creating Compression Stream."
+				   " NOTE: This Error Exits The Corresponding Function.");
+			codec_destroy(codec);
+			return -1;
+		}
+		ZSTD_CCtx_setParameter(codec->compressor, ZSTD_c_compressionLevel, codec_levels[0]);
+		ZSTD_CCtx_setParameter(codec->compressor, ZSTD_c_windowLog, CODEC_WINDOW_LOG);
+	}else if((codec->decompressor = ZSTD_createDCtx()) == NULL){
+		perror("\nIn Function (codec_init), Error Creating Decompression Stream."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		codec_destroy(codec);
+		return -1;
+	}
+	return 0;
+}
+
+
+void codec_destroy(Codec *codec){
+	ZSTD_freeCCtx(codec->compressor);
+	ZSTD_freeDCtx(codec->decompressor);
+	free(codec->input);
+	codec->compressor = NULL;
+	codec->decompressor = NULL;
+	codec->input = NULL;
+}
+
+
+int codec_idle(const Codec *codec){
+	//Nothing Left To Consume And Nothing Left To Emit
+	return codec->input_used == codec->input_length && codec->unflushed == 0;
+}
+
+
+ssize_t codec_read(Codec *codec, int source_fd){
+	ssize_t chars_read;
+
+	//Fresh Input Only Once The Previous Read Is Fully Consumed
+	if((chars_read = read(source_fd, codec->input, CODEC_INPUT_BYTES)) > 0){
+		codec->input_length = chars_read;
+		codec->input_used = 0;
+	}
+	return chars_read;
+}
+
+
+ssize_t codec_run(Codec *codec, char *output, size_t space){
+	ZSTD_inBuffer in = {codec->input, codec->input_length, codec->input_used};
+	ZSTD_outBuffer out = {output, space, 0};
+	size_t result;
+
+	if(codec->mode == CODEC_COMPRESS){
+		//Every Read Is Flushed So The Peer Never Waits On A Partial Block
+		result = ZSTD_compressStream2(codec->compressor, &out, &in,
+									  codec->end_frame ? ZSTD_e_end : ZSTD_e_flush);
+		if(!ZSTD_isError(result)){
+			codec->unflushed = result;
+			if(result == 0 && in.pos == in.size){
+				codec->end_frame = 0;
+			}
+		}
+	}else{
+		//A Full Output Buffer May Leave Decoded Bytes Inside The Stream
+		result = ZSTD_decompressStream(codec->decompressor, &out, &in);
+		codec->unflushed = out.pos == out.size && space > 0;
+	}
+
+	if(ZSTD_isError(result)){
+		fprintf(stderr, "\nIn Function (codec_run), Compressed Stream Error: %s."
+				" NOTE: This Error Exits The Corresponding Function.\n", ZSTD_getErrorName(result));
+		errno = EPROTO;
+		return -1;
+	}
+	codec->input_used = in.pos;
+	return out.pos;
+}
+
+
+void codec_tune(Codec *codec, size_t backlog){
+	int step = codec->step;
+
+	//A Growing Send Queue Means The Link, Not The CPU, Is The Bottleneck
+	if(backlog >= CODEC_BACKLOG_HIGH && step < CODEC_STEPS - 1){
+		step++;
+	}else if(backlog < CODEC_BACKLOG_LOW && step > 0){
+		step--;
+	}
+	if(step == codec->step){
+		return;
+	}
+
+	//Single Threaded Streams Apply A New Level At The Next Frame, So End This One
+	if(ZSTD_isError(ZSTD_CCtx_setParameter(codec->compressor, ZSTD_c_compressionLevel,
+										   codec_levels[step]))){
+		return;
+	}
+	codec->step = step;
+	codec->end_frame = 1;
+}
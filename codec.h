@@ -0,0 +1,36 @@
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <stddef.h>
+#include <sys/types.h>
+#include <zstd.h>
+
+#define CODEC_INPUT_BYTES 16384
+#define CODEC_WINDOW_LOG 18		//256 KiB Of History Bounds Per Session Memory
+#define CODEC_BACKLOG_LOW 4096		//Unsent Socket Bytes Below This Step The Level Down
+#define CODEC_BACKLOG_HIGH 65536	//Unsent Socket Bytes Above This Step The Level Up
+
+typedef enum {CODEC_COMPRESS, CODEC_DECOMPRESS} Codec_Mode;
+
+//One Direction Of A Compressed Stream Declaration
+typedef struct codec_t {
+	Codec_Mode mode;
+	ZSTD_CCtx *compressor;
+	ZSTD_DCtx *decompressor;
+	char *input;		//Bytes Read From The Source Not Yet Consumed
+	size_t input_length;
+	size_t input_used;
+	size_t unflushed;	//Output Still Inside The Stream Waiting For Space
+	int step;			//Index Into The Compression Level Ladder
+	int end_frame;		//A New Level Only Applies From The Next Frame
+} Codec;
+
+//Function Prototypes
+int codec_init(Codec *codec, Codec_Mode mode);
+void codec_destroy(Codec *codec);
+int codec_idle(const Codec *codec);
+ssize_t codec_read(Codec *codec, int source_fd);
+ssize_t codec_run(Codec *codec, char *output, size_t space);
+void codec_tune(Codec *codec, size_t backlog);
+
+#endif
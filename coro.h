@@ -0,0 +1,18 @@
+#ifndef CORO_H
+#define CORO_H
+
+#include <stdint.h>
+
+//Stackless Coroutines In The Style Of Duff's Device. The Resume Point Is The Source
+//Line Of The Last Await, Kept By The Caller In Its Own Object, So Suspending Is A
+//Store And A Return And Resuming Is One Jump. Locals Do Not Survive An Await, And An
+//Await May Not Sit Inside A switch Of The Coroutine's Own
+typedef uint32_t Coro;
+typedef enum {CORO_SUSPENDED, CORO_FINISHED} Coro_Status;
+
+#define CORO_BEGIN(coro) switch(*(coro)){ case 0:
+#define CORO_AWAIT(coro) do{ *(coro) = __LINE__; return CORO_SUSPENDED; case __LINE__:; }while(0)
+#define CORO_EXIT(coro) return CORO_FINISHED
+#define CORO_END(coro) } return CORO_FINISHED
+
+#endif
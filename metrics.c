@@ -0,0 +1,276 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "metrics.h"
+
+//Local Function Prototypes
+static Metrics_Shard *local_shard();
+static void bump(atomic_uint_least64_t *value, uint64_t amount);
+static void *serve_scrapes(void *arg);
+static void write_counter(FILE *out, const char *name, const char *help, const char *label,
+						  const char **values, const Metric_Counter *counters, int count);
+static void write_histogram(FILE *out, const char *name, const char *help, Metric_Histogram histogram);
+
+//Every Thread That Ever Recorded A Metric, Shards Are Never Freed But Are Reused
+static Metrics_Shard *_Atomic shards;
+static __thread Metrics_Shard *shard;
+
+//Scrape Endpoint State
+static int stats_fd = -1;
+static uint64_t (*read_queue_depth)();
+static uint64_t (*read_buffered)();
+
+
+static Metrics_Shard *local_shard(){
+	Metrics_Shard *head;
+
+	if(shard != NULL){
+		return shard;
+	}
+
+	//Adopt A Shard Left By An Exited Thread, Its Totals Keep Counting Toward The Sums
+	for(head = atomic_load_explicit(&shards, memory_order_acquire); head != NULL; head = head->next){
+		int retired = 1;
+		if(atomic_load_explicit(&head->retired, memory_order_relaxed) &&
+		   atomic_compare_exchange_strong_explicit(&head->retired, &retired, 0,
+												   memory_order_acquire, memory_order_relaxed)){
+			return shard = head;
+		}
+	}
+
+	//First Metric From This Thread Publishes Its Shard For The Scraper
+	if((shard = aligned_alloc(METRICS_CACHE_LINE, sizeof(Metrics_Shard))) == NULL){
+		return NULL;
+	}
+	memset(shard, 0, sizeof(Metrics_Shard));
+	head = atomic_load_explicit(&shards, memory_order_relaxed);
+	do{
+		shard->next = head;
+	}while(!atomic_compare_exchange_weak_explicit(&shards, &head, shard,
+												  memory_order_release, memory_order_relaxed));
+	return shard;
+}
+
+
+static void bump(atomic_uint_least64_t *value, uint64_t amount){
+	//Single Writer, So A Plain Load And Store Replaces A Locked Add
+	atomic_store_explicit(value, atomic_load_explicit(value, memory_order_relaxed) + amount,
+						  memory_order_relaxed);
+}
+
+
+void metrics_add(Metric_Counter counter, uint64_t amount){
+	Metrics_Shard *local = local_shard();
+
+	if(local != NULL && amount > 0){
+		bump(&local->counters[counter], amount);
+	}
+}
+
+
+void metrics_observe(Metric_Histogram histogram, uint64_t nanoseconds){
+	Metrics_Shard *local = local_shard();
+	int bucket = 0;
+
+	if(local == NULL){
+		return;
+	}
+
+	//Bucket k Holds Values Below 2^(k + METRICS_BUCKET_BASE) Nanoseconds
+	if(nanoseconds >> METRICS_BUCKET_BASE){
+		bucket = 64 - __builtin_clzll(nanoseconds) - METRICS_BUCKET_BASE;
+	}
+	if(bucket > METRICS_BUCKETS){
+		bucket = METRICS_BUCKETS;
+	}
+	Metrics_Histogram *hist = &local->histograms[histogram];
+	bump(&hist->buckets[bucket], 1);
+	bump(&hist->sum, nanoseconds);
+	bump(&hist->count, 1);
+}
+
+
+void metrics_retire(){
+	//Called By A Thread About To Exit So Its Shard Is Not Stranded
+	if(shard != NULL){
+		atomic_store_explicit(&shard->retired, 1, memory_order_release);
+		shard = NULL;
+	}
+}
+
+
+uint64_t metrics_now(){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+
+int metrics_serve(const char *path, uint64_t (*queue_depth)(), uint64_t (*buffered)()){
+	struct sockaddr_un address;
+	pthread_t scraper;
+
+	//Stats Socket Path Must Fit The Address Structure
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if(strlen(path) >= sizeof(address.sun_path)){
+		perror("\nIn Function (metrics_serve), Stats Socket Path Is Too Long."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	strcpy(address.sun_path, path);
+	read_queue_depth = queue_depth;
+	read_buffered = buffered;
+
+	//A Stale Socket From An Earlier Run Would Make Bind Fail
+	unlink(path);
+	if((stats_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) == -1 ||
+	   bind(stats_fd, (struct sockaddr *) &address, sizeof(address)) == -1 ||
+	   listen(stats_fd, 5) == -1){
+		perror("\nIn Function (metrics_serve), Failed To Create The Stats Socket."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+
+	//Scrapes Are Answered Off The Event Loops
+	if(pthread_create(&scraper, NULL, serve_scrapes, NULL) != 0 || pthread_detach(scraper) != 0){
+		perror("\nIn Function (metrics_serve), Failed To Start The Stats Thread."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	return 0;
+}
+
+
+static void *serve_scrapes(void *arg){
+	static const char *states[] = {"new", "established", "unwritten"};
+	static const Metric_Counter events[] = {METRIC_EVENTS_NEW, METRIC_EVENTS_ESTABLISHED,
+											METRIC_EVENTS_UNWRITTEN};
+	static const char *directions[] = {"to_pty", "to_socket"};
+	static const Metric_Counter bytes[] = {METRIC_BYTES_TO_PTY, METRIC_BYTES_TO_SOCKET};
+	static const char *reasons[] = {"handshake", "idle", "stall"};
+	static const Metric_Counter timeouts[] = {METRIC_HANDSHAKE_TIMEOUTS, METRIC_IDLE_TIMEOUTS,
+											  METRIC_STALL_TIMEOUTS};
+	static const Metric_Counter accepted[] = {METRIC_ACCEPTED};
+	static const Metric_Counter rejected[] = {METRIC_REJECTED};
+	static const Metric_Counter terminated[] = {METRIC_TERMINATED};
+	static const Metric_Counter partial[] = {METRIC_PARTIAL_WRITES};
+	static const Metric_Counter pauses[] = {METRIC_READ_PAUSES};
+	static const char *changes[] = {"started", "retired"};
+	static const Metric_Counter workers[] = {METRIC_WORKERS_STARTED, METRIC_WORKERS_RETIRED};
+	static const char *channel_changes[] = {"opened", "closed"};
+	static const Metric_Counter channels[] = {METRIC_CHANNELS_OPENED, METRIC_CHANNELS_CLOSED};
+	int scrape_fd;
+	char *text;
+	size_t length;
+
+	(void) arg;	//Thread Entry Point, Nothing Is Passed In
+	while(1){
+		if((scrape_fd = accept4(stats_fd, NULL, NULL, SOCK_CLOEXEC)) == -1){
+			continue;
+		}
+
+		//Aggregate Every Shard Only Now, The Hot Path Never Does
+		FILE *out = open_memstream(&text, &length);
+		if(out == NULL){
+			close(scrape_fd);
+			continue;
+		}
+		write_counter(out, "rembash_events_dispatched_total", "Session events dispatched by client state.",
+					  "state", states, events, 3);
+		write_counter(out, "rembash_connections_accepted_total", "Connections accepted.",
+					  NULL, NULL, accepted, 1);
+		write_counter(out, "rembash_connections_rejected_total", "Connections turned away with <busy>.",
+					  NULL, NULL, rejected, 1);
+		write_counter(out, "rembash_sessions_terminated_total", "Sessions torn down.",
+					  NULL, NULL, terminated, 1);
+		write_counter(out, "rembash_relayed_bytes_total", "Bytes written to the destination by direction.",
+					  "direction", directions, bytes, 2);
+		write_counter(out, "rembash_partial_writes_total", "Relay writes the destination did not fully accept.",
+					  NULL, NULL, partial, 1);
+		write_counter(out, "rembash_read_pauses_total", "Times a relay stopped reading its source for backpressure.",
+					  NULL, NULL, pauses, 1);
+		write_counter(out, "rembash_timeouts_total", "Sessions closed by the timer wheel.",
+					  "reason", reasons, timeouts, 3);
+		write_counter(out, "rembash_tpool_workers_total", "Thread pool workers started and retired as load changed.",
+					  "change", changes, workers, 2);
+		write_counter(out, "rembash_mux_channels_total", "Shells opened and closed on multiplexed connections.",
+					  "change", channel_changes, channels, 2);
+		write_histogram(out, "rembash_tpool_queue_wait_seconds", "Time events waited in the thread pool.",
+						METRIC_QUEUE_WAIT);
+		write_histogram(out, "rembash_handshake_duration_seconds", "Time from accept to a verified secret.",
+						METRIC_HANDSHAKE);
+		fprintf(out, "# HELP rembash_tpool_queue_depth Events queued for the thread pool.\n"
+				"# TYPE rembash_tpool_queue_depth gauge\nrembash_tpool_queue_depth %llu\n",
+				(unsigned long long) (read_queue_depth != NULL ? read_queue_depth() : 0));
+		fprintf(out, "# HELP rembash_buffered_bytes Relay bytes waiting on slow destinations.\n"
+				"# TYPE rembash_buffered_bytes gauge\nrembash_buffered_bytes %llu\n",
+				(unsigned long long) (read_buffered != NULL ? read_buffered() : 0));
+		fclose(out);
+
+		//Scrapers Read Until The Server Closes
+		for(size_t sent = 0; sent < length;){
+			ssize_t count = write(scrape_fd, text + sent, length - sent);
+			if(count <= 0){
+				break;
+			}
+			sent += count;
+		}
+		free(text);
+		close(scrape_fd);
+	}
+	return NULL;
+}
+
+
+static void write_counter(FILE *out, const char *name, const char *help, const char *label,
+						  const char **values, const Metric_Counter *counters, int count){
+	Metrics_Shard *each;
+
+	fprintf(out, "# HELP %s %s\n# TYPE %s counter\n", name, help, name);
+	for(int index = 0; index < count; index++){
+		uint64_t total = 0;
+		for(each = atomic_load_explicit(&shards, memory_order_acquire); each != NULL; each = each->next){
+			total += atomic_load_explicit(&each->counters[counters[index]], memory_order_relaxed);
+		}
+		if(label == NULL){
+			fprintf(out, "%s %llu\n", name, (unsigned long long) total);
+		}else{
+			fprintf(out, "%s{%s=\"%s\"} %llu\n", name, label, values[index], (unsigned long long) total);
+		}
+	}
+}
+
+
+static void write_histogram(FILE *out, const char *name, const char *help, Metric_Histogram histogram){
+	Metrics_Shard *each;
+	uint64_t buckets[METRICS_BUCKETS + 1] = {0}, sum = 0, count = 0, cumulative = 0;
+
+	for(each = atomic_load_explicit(&shards, memory_order_acquire); each != NULL; each = each->next){
+		Metrics_Histogram *hist = &each->histograms[histogram];
+		for(int index = 0; index <= METRICS_BUCKETS; index++){
+			buckets[index] += atomic_load_explicit(&hist->buckets[index], memory_order_relaxed);
+		}
+		sum += atomic_load_explicit(&hist->sum, memory_order_relaxed);
+		count += atomic_load_explicit(&hist->count, memory_order_relaxed);
+	}
+
+	//Prometheus Buckets Are Cumulative And End With +Inf
+	fprintf(out, "# HELP %s %s\n# TYPE %s histogram\n", name, help, name);
+	for(int index = 0; index < METRICS_BUCKETS; index++){
+		cumulative += buckets[index];
+		fprintf(out, "%s_bucket{le=\"%.9g\"} %llu\n", name,
+				(double) (1ull << (index + METRICS_BUCKET_BASE)) / 1e9, (unsigned long long) cumulative);
+	}
+	cumulative += buckets[METRICS_BUCKETS];
+	fprintf(out, "%s_bucket{le=\"+Inf\"} %llu\n", name, (unsigned long long) cumulative);
+	fprintf(out, "%s_sum %.9f\n%s_count %llu\n", name, sum / 1e9, name, (unsigned long long) count);
+}
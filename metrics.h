@@ -0,0 +1,61 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define METRICS_BUCKETS 24	//Upper Bounds From 2^10 To 2^33 Nanoseconds Plus +Inf
+#define METRICS_BUCKET_BASE 10
+#define METRICS_CACHE_LINE 64
+
+//Monotonic Counters Kept Per Thread
+typedef enum {
+	METRIC_EVENTS_NEW,
+	METRIC_EVENTS_ESTABLISHED,
+	METRIC_EVENTS_UNWRITTEN,
+	METRIC_ACCEPTED,
+	METRIC_REJECTED,
+	METRIC_TERMINATED,
+	METRIC_BYTES_TO_PTY,
+	METRIC_BYTES_TO_SOCKET,
+	METRIC_PARTIAL_WRITES,
+	METRIC_READ_PAUSES,
+	METRIC_HANDSHAKE_TIMEOUTS,
+	METRIC_IDLE_TIMEOUTS,
+	METRIC_STALL_TIMEOUTS,
+	METRIC_WORKERS_STARTED,
+	METRIC_WORKERS_RETIRED,
+	METRIC_CHANNELS_OPENED,
+	METRIC_CHANNELS_CLOSED,
+	METRIC_COUNTERS
+} Metric_Counter;
+
+//Latency Distributions Kept Per Thread
+typedef enum {
+	METRIC_QUEUE_WAIT,
+	METRIC_HANDSHAKE,
+	METRIC_HISTOGRAMS
+} Metric_Histogram;
+
+typedef struct metrics_histogram_t {
+	atomic_uint_least64_t buckets[METRICS_BUCKETS + 1];
+	atomic_uint_least64_t sum;	//Nanoseconds
+	atomic_uint_least64_t count;
+} Metrics_Histogram;
+
+//Only Its Own Thread Writes A Shard, The Scraper Only Reads
+typedef struct metrics_shard_t {
+	_Alignas(METRICS_CACHE_LINE) atomic_uint_least64_t counters[METRIC_COUNTERS];
+	Metrics_Histogram histograms[METRIC_HISTOGRAMS];
+	atomic_int retired;	//Owner Exited, The Next New Thread Adopts The Shard
+	struct metrics_shard_t *next;
+} Metrics_Shard;
+
+//Function Prototypes
+void metrics_add(Metric_Counter counter, uint64_t amount);
+void metrics_observe(Metric_Histogram histogram, uint64_t nanoseconds);
+uint64_t metrics_now();
+void metrics_retire();
+int metrics_serve(const char *path, uint64_t (*queue_depth)(), uint64_t (*buffered)());
+
+#endif
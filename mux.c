@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <arpa/inet.h>
+#include "mux.h"
+
+//Local Function Prototypes
+static int output_room(Mux_Output *output, size_t length);
+
+
+void mux_pack(char *header, Mux_Type type, uint16_t channel, uint32_t value){
+	uint16_t wire_channel = htons(channel);
+	uint32_t wire_value = htonl(value);
+
+	header[0] = type;
+	header[1] = 0;
+	memcpy(header + 2, &wire_channel, sizeof(wire_channel));
+	memcpy(header + 4, &wire_value, sizeof(wire_value));
+}
+
+
+ssize_t mux_fill(Mux_Input *input, int source_fd){
+	ssize_t chars_read;
+
+	//Move A Partial Frame To The Front, A Whole One Always Fits Behind It
+	if(input->start > 0){
+		memmove(input->buffer, input->buffer + input->start, input->end - input->start);
+		input->end -= input->start;
+		input->start = 0;
+	}
+	if((chars_read = read(source_fd, input->buffer + input->end, MUX_INPUT_BYTES - input->end)) > 0){
+		input->end += chars_read;
+	}
+	return chars_read;
+}
+
+
+int mux_next(Mux_Input *input, Mux_Frame *frame){
+	const char *header = input->buffer + input->start;
+	size_t available = input->end - input->start;
+	uint16_t wire_channel;
+	uint32_t wire_value;
+
+	//Returns One For A Frame, Zero Until One Has Fully Arrived, -1 For A Malformed One
+	if(available < MUX_HEADER){
+		return 0;
+	}
+	memcpy(&wire_channel, header + 2, sizeof(wire_channel));
+	memcpy(&wire_value, header + 4, sizeof(wire_value));
+	frame->type = header[0];
+	frame->channel = ntohs(wire_channel);
+	frame->value = ntohl(wire_value);
+	frame->payload = NULL;
+	if(frame->type < MUX_OPEN || frame->type > MUX_CLOSE || frame->channel >= MUX_MAX_CHANNELS ||
+	   (frame->type == MUX_DATA && frame->value > MUX_MAX_PAYLOAD)){
+		return -1;
+	}
+
+	//Only DATA Frames Carry A Payload After The Header
+	if(frame->type == MUX_DATA){
+		if(available < MUX_HEADER + frame->value){
+			return 0;
+		}
+		frame->payload = header + MUX_HEADER;
+		input->start += frame->value;
+	}
+	input->start += MUX_HEADER;
+	return 1;
+}
+
+
+int mux_output_init(Mux_Output *output, size_t capacity){
+	output->capacity = capacity;
+	output->start = output->end = 0;
+
+	if((output->buffer = malloc(capacity)) == NULL){
+		perror("\nIn Function (mux_output_init), Error Allocating Frame Output Buffer."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	return 0;
+}
+
+
+void mux_output_destroy(Mux_Output *output){
+	free(output->buffer);
+	output->buffer = NULL;
+	output->start = output->end = 0;
+}
+
+
+size_t mux_pending(const Mux_Output *output){
+	return output->end - output->start;
+}
+
+
+static int output_room(Mux_Output *output, size_t length){
+	size_t capacity = output->capacity;
+	char *buffer;
+
+	//Sent Bytes Are Reclaimed Before The Buffer Grows
+	if(output->capacity - output->end >= length){
+		return 0;
+	}
+	if(output->start > 0){
+		memmove(output->buffer, output->buffer + output->start, output->end - output->start);
+		output->end -= output->start;
+		output->start = 0;
+	}
+	if(output->capacity - output->end >= length){
+		return 0;
+	}
+	while(capacity - output->end < length){
+		capacity <<= 1;
+	}
+	if((buffer = realloc(output->buffer, capacity)) == NULL){
+		perror("\nIn Function (output_room), Error Growing Frame Output Buffer."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	output->buffer = buffer;
+	output->capacity = capacity;
+	return 0;
+}
+
+
+int mux_send(Mux_Output *output, Mux_Type type, uint16_t channel, uint32_t value,
+			 const char *payload){
+	size_t length = type == MUX_DATA ? value : 0;
+
+	//Control Frames Are Never Refused, They Are Bounded By The Open Channels
+	if(output_room(output, MUX_HEADER + length) == -1){
+		return -1;
+	}
+	mux_pack(output->buffer + output->end, type, channel, value);
+	if(length > 0){
+		memcpy(output->buffer + output->end + MUX_HEADER, payload, length);
+	}
+	output->end += MUX_HEADER + length;
+	return 0;
+}
+
+
+char *mux_reserve(Mux_Output *output, size_t *space){
+	//Producers Read Straight Into The Payload Slot Of A DATA Frame
+	if(output->capacity - output->end < MUX_HEADER + MUX_MAX_PAYLOAD && output->start > 0){
+		memmove(output->buffer, output->buffer + output->start, output->end - output->start);
+		output->end -= output->start;
+		output->start = 0;
+	}
+	*space = output->capacity - output->end > MUX_HEADER ? output->capacity - output->end - MUX_HEADER : 0;
+	if(*space > MUX_MAX_PAYLOAD){
+		*space = MUX_MAX_PAYLOAD;
+	}
+	return output->buffer + output->end + MUX_HEADER;
+}
+
+
+void mux_commit(Mux_Output *output, uint16_t channel, size_t length){
+	mux_pack(output->buffer + output->end, MUX_DATA, channel, length);
+	output->end += MUX_HEADER + length;
+}
+
+
+ssize_t mux_flush(Mux_Output *output, int dest_fd){
+	ssize_t chars_written;
+
+	//Returns The Bytes Still Pending Once The Destination Is Full, -1 On Error
+	while(output->end > output->start){
+		if((chars_written = write(dest_fd, output->buffer + output->start, output->end - output->start)) < 0){
+			if(errno == EAGAIN || errno == EWOULDBLOCK){
+				break;
+			}
+			return -1;
+		}
+		output->start += chars_written;
+	}
+	if(output->start == output->end){
+		output->start = output->end = 0;
+	}
+	return output->end - output->start;
+}
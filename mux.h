@@ -0,0 +1,56 @@
+#ifndef MUX_H
+#define MUX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#define MUX_FEATURE "+mux"
+#define MUX_HEADER 8			//Type, Reserved Byte, Channel And Value In Network Order
+#define MUX_MAX_PAYLOAD 16384
+#define MUX_MAX_CHANNELS 1024
+#define MUX_WINDOW 16384		//Credit Each Side Grants A Fresh Channel
+#define MUX_INPUT_BYTES (2 * (MUX_HEADER + MUX_MAX_PAYLOAD))
+#define MUX_OUTPUT_BYTES 65536
+#define MUX_ESCAPE 0x1d		//Ctrl-] Starts A Client Channel Command
+
+typedef enum {MUX_OPEN = 1, MUX_DATA, MUX_CREDIT, MUX_CLOSE} Mux_Type;
+
+//DATA Carries Value Bytes Of Payload, CREDIT Lets The Receiver Of The Frame Send Value
+//More Bytes On The Channel, OPEN Carries The Opener's Initial Credit And CLOSE Nothing
+typedef struct mux_frame_t {
+	uint8_t type;
+	uint16_t channel;
+	uint32_t value;
+	const char *payload;	//DATA Only, Valid Until The Next Fill
+} Mux_Frame;
+
+//Socket Bytes Reassembled Into Whole Frames
+typedef struct mux_input_t {
+	char buffer[MUX_INPUT_BYTES];
+	size_t start;
+	size_t end;
+} Mux_Input;
+
+//Frames Waiting For The Socket, Growing Past Its Capacity Only For Control Frames
+typedef struct mux_output_t {
+	char *buffer;
+	size_t capacity;
+	size_t start;
+	size_t end;
+} Mux_Output;
+
+//Function Prototypes
+void mux_pack(char *header, Mux_Type type, uint16_t channel, uint32_t value);
+ssize_t mux_fill(Mux_Input *input, int source_fd);
+int mux_next(Mux_Input *input, Mux_Frame *frame);
+int mux_output_init(Mux_Output *output, size_t capacity);
+void mux_output_destroy(Mux_Output *output);
+size_t mux_pending(const Mux_Output *output);
+int mux_send(Mux_Output *output, Mux_Type type, uint16_t channel, uint32_t value,
+			 const char *payload);
+char *mux_reserve(Mux_Output *output, size_t *space);
+void mux_commit(Mux_Output *output, uint16_t channel, size_t length);
+ssize_t mux_flush(Mux_Output *output, int dest_fd);
+
+#endif
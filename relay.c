@@ -0,0 +1,430 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include "relay.h"
+
+//Local Function Prototypes
+static Relay_Status pump_copy(Relay *relay);
+static Relay_Status pump_splice(Relay *relay);
+static int fall_back_to_copy(Relay *relay);
+static Relay_Status source_closed(Relay *relay);
+static ssize_t relay_fill(Relay *relay);
+static void relay_grow(Relay *relay);
+static void relay_watermark(Relay *relay);
+static void relay_account(Relay *relay);
+
+//Pending Bytes Across Every Session And The Ceiling That Throttles Them, Zero For None
+static atomic_size_t buffered_bytes;
+static size_t buffered_budget;
+static __thread int over_budget;	//Sampled Once Per Pass
+
+
+int relay_init(Relay *relay, int source_fd, int dest_fd, Relay_Mode mode, size_t capacity, int node){
+	int size;
+	
+	relay->source_fd = source_fd;
+	relay->dest_fd = dest_fd;
+	relay->pipe_fds[0] = relay->pipe_fds[1] = -1;
+	relay->piped = 0;
+	relay->pipe_size = 0;
+	relay->hold_below = 0;
+	relay->held = 0;
+	relay->codec = NULL;
+	relay->paused = 0;
+	relay->accounted = 0;
+	relay->ring.buffer = NULL;
+	relay->ring.capacity = relay->ring.head = relay->ring.tail = 0;
+	relay->ring.node = node;	//Kept For A Splice Relay That Falls Back To Copying
+	relay->ring_limit = 0;
+	
+	//Idle Sessions Only Ever Hold A Small Ring, Busy Ones Grow It On Demand
+	if(mode == RELAY_COPY){
+		if(ring_init(&relay->ring, capacity < RELAY_INITIAL_RING ? capacity : RELAY_INITIAL_RING, node) == -1){
+			return -1;
+		}
+		relay->ring_limit = relay->ring.capacity;
+		while(relay->ring_limit < capacity){
+			relay->ring_limit <<= 1;
+		}
+		relay->high_water = relay->ring_limit - relay->ring_limit / 4;
+		relay->low_water = relay->ring_limit / 4;
+		return 0;
+	}
+	
+	//Bytes Move Socket To Pipe To PTY Without Entering User Space
+	if(pipe2(relay->pipe_fds, O_CLOEXEC | O_NONBLOCK) == -1){
+		perror("\nIn Function (relay_init), Error Creating Splice Pipe For Client."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	
+	//Grow The Pipe Toward The Requested Capacity, Keeping The Default If Refused
+	fcntl(relay->pipe_fds[1], F_SETPIPE_SZ, (int) capacity);
+	if((size = fcntl(relay->pipe_fds[1], F_GETPIPE_SZ)) == -1){
+		perror("\nIn Function (relay_init), Error Reading Splice Pipe Size."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		relay_destroy(relay);
+		return -1;
+	}
+	relay->pipe_size = size;
+	relay->high_water = size - size / 4;
+	relay->low_water = size / 4;
+	return 0;
+}
+
+
+void relay_destroy(Relay *relay){
+	//Whatever Was Still Pending Leaves The Server Budget With The Session
+	if(relay->accounted > 0){
+		atomic_fetch_sub_explicit(&buffered_bytes, relay->accounted, memory_order_relaxed);
+		relay->accounted = 0;
+	}
+	if(relay->pipe_fds[0] != -1){
+		close(relay->pipe_fds[0]);
+		close(relay->pipe_fds[1]);
+		relay->pipe_fds[0] = relay->pipe_fds[1] = -1;
+	}
+	ring_destroy(&relay->ring);
+	if(relay->codec != NULL){
+		codec_destroy(relay->codec);
+		free(relay->codec);
+		relay->codec = NULL;
+	}
+}
+
+
+int relay_compress(Relay *relay, Codec_Mode mode){
+	//Streams Are Transformed In User Space So Only The Copy Path Can Carry Them
+	if(relay->pipe_fds[0] != -1){
+		perror("\nIn Function (relay_compress), Spliced Relays Cannot Be Compressed."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	if((relay->codec = malloc(sizeof(Codec))) == NULL){
+		perror("\nIn Function (relay_compress), Error Allocating Compression State."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	if(codec_init(relay->codec, mode) == -1){
+		free(relay->codec);
+		relay->codec = NULL;
+		return -1;
+	}
+	return 0;
+}
+
+
+size_t relay_pending(const Relay *relay){
+	if(relay->pipe_fds[0] != -1){
+		return relay->piped;
+	}
+	return ring_used(&relay->ring);
+}
+
+
+size_t relay_space(const Relay *relay){
+	if(relay->pipe_fds[0] != -1){
+		return relay->pipe_size - relay->piped;
+	}
+	return ring_free(&relay->ring);
+}
+
+
+void relay_hold(Relay *relay, size_t bytes){
+	size_t capacity = relay->pipe_fds[0] != -1 ? relay->pipe_size : relay->ring.capacity;
+	
+	//A Full Buffer Always Flushes Or The Source Could Never Be Read Again
+	relay->hold_below = bytes < capacity ? bytes : capacity;
+}
+
+
+Relay_Status pump_relay(Relay *relay){
+	Relay_Status status;
+	
+	//Per Pass Statistics Read By The Caller Afterwards
+	relay->moved = 0;
+	relay->partial_writes = 0;
+	relay->pauses = 0;
+	relay->held = 0;
+	over_budget = buffered_budget > 0 &&
+				  atomic_load_explicit(&buffered_bytes, memory_order_relaxed) > buffered_budget;
+	
+	//Either Watermark May Have Moved Since The Last Pass Under Budget Pressure
+	relay_watermark(relay);
+	if(relay->pipe_fds[0] != -1){
+		status = pump_splice(relay);
+	}else{
+		status = pump_copy(relay);
+	}
+	
+	//Empty Rings Give Their Growth Back While The Server Is Over Budget
+	if(over_budget && relay->pipe_fds[0] == -1 && relay->ring.buffer != NULL &&
+	   ring_used(&relay->ring) == 0 && relay->ring.capacity > RELAY_INITIAL_RING){
+		ring_resize(&relay->ring, RELAY_INITIAL_RING);
+	}
+	relay_account(relay);
+	return status;
+}
+
+
+static void relay_watermark(Relay *relay){
+	size_t pending = relay_pending(relay);
+	
+	//Over Budget The Low Watermark Becomes The High One, So The Heaviest Sessions Stop First
+	if(!relay->paused && (pending >= relay->high_water || (over_budget && pending > relay->low_water))){
+		relay->paused = 1;
+		relay->pauses++;
+	}else if(relay->paused && pending <= relay->low_water){
+		relay->paused = 0;
+	}
+}
+
+
+static void relay_grow(Relay *relay){
+	//A Full Ring Doubles Unless It Is At Its Limit Or The Server Is Over Budget
+	if(over_budget || relay->ring.capacity >= relay->ring_limit){
+		return;
+	}
+	ring_resize(&relay->ring, relay->ring.capacity * 2);
+}
+
+
+static void relay_account(Relay *relay){
+	size_t pending = relay_pending(relay);
+	
+	//Only Passes That End With Bytes Left Touch The Shared Counter
+	if(pending > relay->accounted){
+		atomic_fetch_add_explicit(&buffered_bytes, pending - relay->accounted, memory_order_relaxed);
+	}else if(pending < relay->accounted){
+		atomic_fetch_sub_explicit(&buffered_bytes, relay->accounted - pending, memory_order_relaxed);
+	}
+	relay->accounted = pending;
+}
+
+
+void relay_set_budget(size_t bytes){
+	buffered_budget = bytes;
+}
+
+
+uint64_t relay_buffered(){
+	return atomic_load_explicit(&buffered_bytes, memory_order_relaxed);
+}
+
+
+static Relay_Status pump_copy(Relay *relay){
+	ssize_t count;
+	int source_dry = 0, dest_blocked = 0;
+	size_t moved = 0;
+	
+	while(1){
+		//Keep Reading While The Ring Has Space And The Destination Keeps Up
+		if(!source_dry && !relay->paused && ring_free(&relay->ring) > 0){
+			if((count = relay_fill(relay)) == 0){
+				return source_closed(relay);
+			}else if(count < 0){
+				if(errno != EAGAIN){
+					return source_closed(relay);
+				}
+				source_dry = 1;
+			}else if(ring_free(&relay->ring) == 0){
+				relay_grow(relay);
+			}
+			relay_watermark(relay);
+		}
+		
+		//Write Out Whatever Is Pending Until The Destination Pushes Back
+		if(!dest_blocked && ring_used(&relay->ring) > 0 &&
+		   (ring_used(&relay->ring) >= relay->hold_below || relay->paused)){
+			if((count = ring_drain(&relay->ring, relay->dest_fd)) < 0){
+				if(errno != EAGAIN){
+					perror("\nIn Function (pump_copy), Error Writing... NOTE: This Error"
+						   " Exits The Corresponding Function");
+					return RELAY_CLOSED;
+				}
+				dest_blocked = 1;
+				relay->partial_writes++;
+			}else{
+				moved += count;
+				relay->moved += count;
+				relay_watermark(relay);
+			}
+		}
+		
+		if(source_dry && ring_used(&relay->ring) == 0){
+			return RELAY_IDLE;
+		}
+		if(source_dry && !dest_blocked && ring_used(&relay->ring) < relay->hold_below){
+			relay->held = 1;
+			return RELAY_HELD;
+		}
+		if(dest_blocked && (source_dry || relay->paused || ring_free(&relay->ring) == 0)){
+			return RELAY_BLOCKED;
+		}
+		
+		//Hand The Worker Back After A Bounded Amount Of Bulk Traffic
+		if(moved >= relay->ring_limit * RELAY_PASS_LIMIT){
+			return RELAY_YIELD;
+		}
+	}
+}
+
+
+static Relay_Status pump_splice(Relay *relay){
+	ssize_t count;
+	int source_dry = 0, dest_blocked = 0, pipe_full = 0, available;
+	size_t moved = 0;
+	
+	while(1){
+		//Move Source Bytes Into The Pipe While It Has Room
+		if(!source_dry && !relay->paused && relay->piped < relay->pipe_size){
+			count = splice(relay->source_fd, NULL, relay->pipe_fds[1], NULL,
+						   relay->pipe_size - relay->piped, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+			if(count == 0){
+				return source_closed(relay);
+			}else if(count < 0){
+				if(errno == EINVAL && fall_back_to_copy(relay) == 0){
+					return pump_copy(relay);
+				}else if(errno != EAGAIN){
+					return source_closed(relay);
+				}else if(relay->piped > 0 && ioctl(relay->source_fd, FIONREAD, &available) == 0 && available > 0){
+					pipe_full = 1;	//Small Reads Each Take A Pipe Page, So Slots Run Out Before Bytes Do
+				}else{
+					source_dry = 1;
+				}
+			}else{
+				relay->piped += count;
+			}
+			relay_watermark(relay);
+		}
+		
+		//Move Piped Bytes Out Until The Destination Pushes Back
+		if(!dest_blocked && relay->piped > 0 && (relay->piped >= relay->hold_below || pipe_full || relay->paused)){
+			count = splice(relay->pipe_fds[0], NULL, relay->dest_fd, NULL,
+						   relay->piped, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+			if(count < 0){
+				if(errno == EINVAL && fall_back_to_copy(relay) == 0){
+					return pump_copy(relay);
+				}else if(errno != EAGAIN){
+					perror("\nIn Function (pump_splice), Error Splicing... NOTE: This Error"
+						   " Exits The Corresponding Function");
+					return RELAY_CLOSED;
+				}
+				dest_blocked = 1;
+				relay->partial_writes++;
+			}else{
+				relay->piped -= count;
+				pipe_full = 0;
+				moved += count;
+				relay->moved += count;
+				relay_watermark(relay);
+			}
+		}
+		
+		if(source_dry && relay->piped == 0){
+			return RELAY_IDLE;
+		}
+		if(source_dry && !dest_blocked && relay->piped < relay->hold_below){
+			relay->held = 1;
+			return RELAY_HELD;
+		}
+		if(dest_blocked && (source_dry || pipe_full || relay->paused || relay->piped == relay->pipe_size)){
+			return RELAY_BLOCKED;
+		}
+		
+		//Hand The Worker Back After A Bounded Amount Of Bulk Traffic
+		if(moved >= relay->pipe_size * RELAY_PASS_LIMIT){
+			return RELAY_YIELD;
+		}
+	}
+}
+
+
+static ssize_t relay_fill(Relay *relay){
+	char *segment;
+	size_t space;
+	ssize_t count;
+	
+	if(relay->codec == NULL){
+		return ring_fill(&relay->ring, relay->source_fd);
+	}
+	
+	//Leftover Input Or Output Is Worked Off Before The Source Is Read Again
+	if(codec_idle(relay->codec) && (count = codec_read(relay->codec, relay->source_fd)) <= 0){
+		return count;
+	}
+	space = ring_reserve(&relay->ring, &segment);
+	if((count = codec_run(relay->codec, segment, space)) == -1){
+		return -1;
+	}
+	ring_commit(&relay->ring, count);
+	
+	//Progress Is Reported Even When The Stream Swallowed The Input Without Output Yet
+	return 1;
+}
+
+
+static Relay_Status source_closed(Relay *relay){
+	ssize_t count = 1;
+	
+	//Held Or Pending Bytes Still Go Out If The Destination Takes Them Right Away
+	while(count > 0 && relay_pending(relay) > 0){
+		if(relay->pipe_fds[0] != -1){
+			count = splice(relay->pipe_fds[0], NULL, relay->dest_fd, NULL,
+						   relay->piped, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+			relay->piped -= count > 0 ? count : 0;
+		}else{
+			count = ring_drain(&relay->ring, relay->dest_fd);
+		}
+		relay->moved += count > 0 ? count : 0;
+	}
+	return RELAY_CLOSED;
+}
+
+
+static int fall_back_to_copy(Relay *relay){
+	ssize_t count;
+	
+	//Descriptors Without Splice Support Continue On The Read/Write Path
+	if(ring_init(&relay->ring, relay->pipe_size > relay->piped ? relay->pipe_size : relay->piped,
+				 relay->ring.node) == -1){
+		return -1;
+	}
+	
+	//Carry Over Whatever Is Still Sitting In The Pipe
+	while(relay->piped > 0){
+		if((count = ring_fill(&relay->ring, relay->pipe_fds[0])) <= 0){
+			ring_destroy(&relay->ring);
+			return -1;
+		}
+		relay->piped -= count;
+	}
+	close(relay->pipe_fds[0]);
+	close(relay->pipe_fds[1]);
+	relay->pipe_fds[0] = relay->pipe_fds[1] = -1;
+	relay->ring_limit = relay->ring.capacity;
+	return 0;
+}
+
+
+uint32_t relay_events(Relay *inbound, Relay *outbound){
+	uint32_t events = 0;
+	
+	//Read From The Source Only While Its Outbound Buffer Has Space And Is Not Paused
+	if(!outbound->paused && relay_space(outbound) > 0){
+		events |= EPOLLIN;
+	}
+	
+	//Wait For Writability Only While Inbound Bytes Are Pending, Held Bytes Wait For Their Flush
+	if(relay_pending(inbound) > 0 && !inbound->held){
+		events |= EPOLLOUT;
+	}
+	return events;
+}
@@ -0,0 +1,48 @@
+#ifndef RELAY_H
+#define RELAY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ring.h"
+#include "codec.h"
+
+#define RELAY_PASS_LIMIT 8
+#define RELAY_INITIAL_RING 4096	//Copy Rings Start Here And Double Toward Their Capacity
+
+typedef enum {RELAY_COPY, RELAY_SPLICE} Relay_Mode;
+typedef enum {RELAY_IDLE, RELAY_BLOCKED, RELAY_YIELD, RELAY_HELD, RELAY_CLOSED} Relay_Status;
+
+//One Direction Of A Session Declaration
+typedef struct relay_t {
+	Ring ring;			//Copy Mode User Space Buffer
+	size_t ring_limit;	//Largest The Ring May Grow To
+	int pipe_fds[2];	//Splice Mode Kernel Buffer, -1 When Copying
+	size_t piped;		//Bytes Still Sitting In The Pipe
+	size_t pipe_size;
+	int source_fd;
+	int dest_fd;
+	Codec *codec;		//Compresses Or Decompresses Between Source And Ring, NULL For Raw Bytes
+	size_t hold_below;		//Pending Bytes Under This Wait For A Flush, Zero Writes At Once
+	int held;				//The Last Pass Kept Bytes Back For Coalescing
+	size_t high_water;		//Pending Bytes That Pause Reads From The Source
+	size_t low_water;		//Pending Bytes That Resume Them
+	int paused;
+	size_t accounted;		//Pending Bytes Counted Against The Server Budget
+	size_t moved;			//Bytes Written By The Last Pass
+	unsigned partial_writes;	//Times The Last Pass Found The Destination Full
+	unsigned pauses;		//Times The Last Pass Paused Reading
+} Relay;
+
+//Function Prototypes
+int relay_init(Relay *relay, int source_fd, int dest_fd, Relay_Mode mode, size_t capacity, int node);
+void relay_destroy(Relay *relay);
+int relay_compress(Relay *relay, Codec_Mode mode);
+size_t relay_pending(const Relay *relay);
+size_t relay_space(const Relay *relay);
+void relay_hold(Relay *relay, size_t bytes);
+Relay_Status pump_relay(Relay *relay);
+uint32_t relay_events(Relay *inbound, Relay *outbound);
+void relay_set_budget(size_t bytes);
+uint64_t relay_buffered();
+
+#endif
@@ -0,0 +1,92 @@
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <string.h>
+#include "readline.c"
+#include "rembash.h"
+
+
+int setup_socket(char *wanted_address){
+	
+	//Creates and Catches Socket 
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+	
+	if(sockfd < 0){
+		perror("\nIn Function (setup_socket), Error Connecting Client Socket"
+					   " To Wanted Address. Note: Error Exits Function.\n");
+		return -1;
+	}
+	
+	//Address Initialization
+	struct sockaddr_in address;
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = inet_addr(wanted_address);
+    address.sin_port = htons(PORT);
+
+	//Connects Socket with Specified Address
+    int connect_result = connect(sockfd, (struct sockaddr *) &address, sizeof(address));
+	if(connect_result == -1){
+        perror("\nIn Function (setup_socket), Error Connecting Client Socket End"
+					   " To The Server. Note: Error Exits Function.\n");
+		close(sockfd);
+		return -1;
+    }
+	return sockfd;
+}
+
+
+int handle_rembash(int sockfd, const char *feature){
+	
+	const char * const rembash_message = "<rembash>\n";
+	const char * const ok_message = "<ok>\n";
+	char secret_message[64], accepted_message[32];
+	
+	//An Optional Feature Suffix Such As +zstd Rides On Both Handshake Lines
+	feature = feature != NULL ? feature : "";
+	snprintf(secret_message, sizeof(secret_message), "<%s%s>\n", SECRET, feature);
+	snprintf(accepted_message, sizeof(accepted_message), "<ok%s>\n", feature);
+	
+	//Rembash Protocol Verification
+	char *message_buffer = readline(sockfd);
+	
+	//Servers Shedding A Connection Storm Answer <busy> Instead
+	if(message_buffer != NULL && strcmp("<busy>\n", message_buffer) == 0){
+		fprintf(stderr, "\nIn Function (handle_rembash), The Server Is Busy, Try Again"
+				" Shortly. Note: Error Exits Function.\n");
+		return -1;
+	}
+	if(message_buffer == NULL || strcmp(rembash_message, message_buffer) != 0){
+		perror("\nIn Function (handle_rembash), Incorrect Rembash Message."
+			   " Note: Error Exits Function.\n");
+		return -1;
+	}
+	
+	//Secret Message Send
+	int secret_length = strlen(secret_message);
+    if(write(sockfd, secret_message, secret_length) < secret_length){
+		perror("\nIn Function (handle_rembash), Incorrect Secret Message."
+			   " Note: Error Exits Function.\n");
+		return -1;
+	}
+    
+	//Checks Secert Message Server Response
+	if((message_buffer = readline(sockfd)) == NULL){
+		perror("\nIn Function (handle_rembash), Error Reading From Socket"
+			   " Note: Error Exits Function.\n");
+		return -1;
+	}
+	
+	//Servers Without The Feature Still Accept The Session Plainly
+	if(*feature != '\0' && strcmp(accepted_message, message_buffer) == 0){
+		return 1;
+	}
+    if(strcmp(ok_message, message_buffer) != 0){
+		perror("\nIn Function (handle_rembash), Could Not Send OK Message"
+			   " Note: Error Exits Function.\n");
+		return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef REMBASH_H
+#define REMBASH_H
+
+#define PORT 4070
+#define SECRET "cs407rembash"
+
+//Client Side Of The Rembash Protocol Shared By The Client And The Benchmark
+int setup_socket(char *wanted_address);
+int handle_rembash(int sockfd, const char *feature);
+
+#endif
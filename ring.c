@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include "ring.h"
+#include "topology.h"
+
+//Local Function Prototypes
+static size_t round_capacity(size_t capacity);
+static char *alloc_buffer(size_t capacity, int node);
+static void free_buffer(char *buffer, size_t capacity, int node);
+static int free_segments(Ring *ring, struct iovec *segments);
+static int used_segments(Ring *ring, struct iovec *segments);
+
+
+static size_t round_capacity(size_t capacity){
+	size_t rounded = 1;
+	
+	while(rounded < capacity){
+		rounded <<= 1;
+	}
+	return rounded;
+}
+
+
+static char *alloc_buffer(size_t capacity, int node){
+	size_t page = sysconf(_SC_PAGESIZE);
+	char *buffer;
+	
+	//Unplaced Rings Come From The Heap, Placed Ones From Pages Bound Before Any Thread Touches Them
+	if(node < 0){
+		return malloc(capacity);
+	}
+	capacity = (capacity + page - 1) & ~(page - 1);
+	if((buffer = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED){
+		return NULL;
+	}
+	
+	//The Policy Is Only A Preference, An Unbound Buffer Still Relays Correctly
+	topology_bind(buffer, capacity, node);
+	return buffer;
+}
+
+
+static void free_buffer(char *buffer, size_t capacity, int node){
+	if(node < 0){
+		free(buffer);
+	}else if(buffer != NULL){
+		munmap(buffer, capacity);
+	}
+}
+
+
+int ring_init(Ring *ring, size_t capacity, int node){
+	
+	//Masking Offsets Requires A Power Of Two Capacity
+	ring->capacity = round_capacity(capacity == 0 ? RING_DEFAULT_CAPACITY : capacity);
+	ring->head = 0;
+	ring->tail = 0;
+	ring->node = node;
+	
+	if((ring->buffer = alloc_buffer(ring->capacity, node)) == NULL){
+		perror("\nIn Function (ring_init), Error Allocating Relay Buffer For Client."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	return 0;
+}
+
+
+void ring_destroy(Ring *ring){
+	free_buffer(ring->buffer, ring->capacity, ring->node);
+	ring->buffer = NULL;
+	ring->head = ring->tail = 0;
+}
+
+
+size_t ring_used(const Ring *ring){
+	return ring->head - ring->tail;
+}
+
+
+size_t ring_free(const Ring *ring){
+	return ring->capacity - (ring->head - ring->tail);
+}
+
+
+static int free_segments(Ring *ring, struct iovec *segments){
+	size_t space = ring_free(ring);
+	size_t offset = ring->head & (ring->capacity - 1);
+	size_t first = ring->capacity - offset;
+	
+	//Free Space May Wrap Around The End Of The Buffer
+	if(first >= space){
+		segments[0].iov_base = ring->buffer + offset;
+		segments[0].iov_len = space;
+		return 1;
+	}
+	segments[0].iov_base = ring->buffer + offset;
+	segments[0].iov_len = first;
+	segments[1].iov_base = ring->buffer;
+	segments[1].iov_len = space - first;
+	return 2;
+}
+
+
+static int used_segments(Ring *ring, struct iovec *segments){
+	size_t pending = ring_used(ring);
+	size_t offset = ring->tail & (ring->capacity - 1);
+	size_t first = ring->capacity - offset;
+	
+	//Pending Bytes May Wrap Around The End Of The Buffer
+	if(first >= pending){
+		segments[0].iov_base = ring->buffer + offset;
+		segments[0].iov_len = pending;
+		return 1;
+	}
+	segments[0].iov_base = ring->buffer + offset;
+	segments[0].iov_len = first;
+	segments[1].iov_base = ring->buffer;
+	segments[1].iov_len = pending - first;
+	return 2;
+}
+
+
+ssize_t ring_fill(Ring *ring, int source_fd){
+	struct iovec segments[2];
+	ssize_t chars_read;
+	
+	//Read Into Every Free Byte With A Single System Call
+	int count = free_segments(ring, segments);
+	if((chars_read = readv(source_fd, segments, count)) > 0){
+		ring->head += chars_read;
+	}
+	return chars_read;
+}
+
+
+ssize_t ring_drain(Ring *ring, int dest_fd){
+	struct iovec segments[2];
+	ssize_t chars_written;
+	
+	//Write Every Pending Byte With A Single System Call
+	int count = used_segments(ring, segments);
+	if((chars_written = writev(dest_fd, segments, count)) > 0){
+		ring->tail += chars_written;
+	}
+	return chars_written;
+}
+
+
+size_t ring_reserve(Ring *ring, char **segment){
+	struct iovec segments[2];
+	
+	//Producers Other Than read() Write Into The First Free Segment Directly
+	free_segments(ring, segments);
+	*segment = segments[0].iov_base;
+	return segments[0].iov_len;
+}
+
+
+void ring_commit(Ring *ring, size_t count){
+	ring->head += count;
+}
+
+
+int ring_resize(Ring *ring, size_t capacity){
+	struct iovec segments[2];
+	size_t pending = ring_used(ring), copied = 0;
+	char *buffer;
+	
+	//Pending Bytes Must Fit And The Capacity Must Stay A Power Of Two
+	capacity = round_capacity(capacity);
+	if(capacity < pending){
+		return -1;
+	}
+	if((buffer = alloc_buffer(capacity, ring->node)) == NULL){
+		return -1;
+	}
+	
+	//Pending Bytes Move To The Front Of The New Buffer In Order
+	int count = used_segments(ring, segments);
+	for(int index = 0; index < count; index++){
+		memcpy(buffer + copied, segments[index].iov_base, segments[index].iov_len);
+		copied += segments[index].iov_len;
+	}
+	free_buffer(ring->buffer, ring->capacity, ring->node);
+	ring->buffer = buffer;
+	ring->capacity = capacity;
+	ring->tail = 0;
+	ring->head = pending;
+	return 0;
+}
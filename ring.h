@@ -0,0 +1,29 @@
+#ifndef RING_H
+#define RING_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#define RING_DEFAULT_CAPACITY 16384
+
+//Directional Byte Ring Declaration
+typedef struct ring_t {
+	char *buffer;
+	size_t capacity;	//Always A Power Of Two
+	size_t head;		//Total Bytes Written Into Ring
+	size_t tail;		//Total Bytes Consumed From Ring
+	int node;			//NUMA Node The Buffer Is Bound To, -1 For Heap Memory
+} Ring;
+
+//Function Prototypes
+int ring_init(Ring *ring, size_t capacity, int node);
+void ring_destroy(Ring *ring);
+size_t ring_used(const Ring *ring);
+size_t ring_free(const Ring *ring);
+ssize_t ring_fill(Ring *ring, int source_fd);
+ssize_t ring_drain(Ring *ring, int dest_fd);
+size_t ring_reserve(Ring *ring, char **segment);
+void ring_commit(Ring *ring, size_t count);
+int ring_resize(Ring *ring, size_t capacity);
+
+#endif
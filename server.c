@@ -21,9 +21,9 @@ Use and Development Notes:
 	
 A Note About Dyanmic Memory Allocation:
 	Within this program, several instances of dynamic memory allocation are used to
-	transfer data or client objects. This current version does not free this allocated
-	memory but rather uses its own memory handling through a preallocated list of
-	memory.
+	transfer data or client objects. Client objects are not allocated per connection
+	but are taken from a preallocated slab of cache line aligned slots whose free list
+	is a Linked_Memory chain. Terminated clients return their slot to that list.
 **************************************************************************************/
 
 #define _XOPEN_SOURCE 600
@@ -34,6 +34,7 @@ A Note About Dyanmic Memory Allocation:
 #include <signal.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <fcntl.h>
 #include <termios.h>
@@ -41,54 +42,130 @@ A Note About Dyanmic Memory Allocation:
 #include <time.h>
 #include <sys/timerfd.h>
 #include <sys/ioctl.h>
+#include <linux/sockios.h>
 #include <sys/wait.h>
 #include <sys/epoll.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <netinet/tcp.h>
 #include <errno.h>
-#include "readline.c"
+#include <spawn.h>
+#include <stdatomic.h>
 #include "tpool.h"
+#include "relay.h"
+#include "timer_wheel.h"
+#include "session_table.h"
+#include "uring.h"
+#include "metrics.h"
+#include "shell_pool.h"
+#include "topology.h"
+#include "coro.h"
+#include "channel.h"
 
 #define MAX_BUFF 4024
 #define MAX_TIMER_AMOUNT 5
+#define STALL_TIMER_AMOUNT 60
 #define MAX_CLIENTS 100000
-#define REARM_IN 0
-#define REARM_OUT 1
+#define CACHE_LINE 64
+#define EPOLL_BATCH 256
+#define URING_BUFFERS 1024
+#define URING_FLOWS 2
+#define FLOW_TO_PTY 0
+#define FLOW_TO_SOCKET 1
+#define COALESCE_BYTES 16384
+#define COALESCE_MICROSECONDS 500
+#define INTERACTIVE_MS 50
+#define BUFFER_BUDGET_MB 256
+#define LISTEN_BACKLOG 4096	//The Kernel Caps This At net.core.somaxconn
+#define ACCEPT_BATCH 64
+#define MAX_PENDING_HANDSHAKES 1024
+#define BULK_PASS_BYTES 4096	//A Relay Pass Moving This Much Sends Its Source's Events To The Bulk Lane
+#define REARM_IN EPOLLIN
+#define REARM_OUT EPOLLOUT
 #define NOT_MARK 0
 #define MARK 1
 #define PORT 4070
 #define SECRET "cs407rembash"
+#define HANDSHAKE_PREFIX "<" SECRET
+#define HANDSHAKE_MAX 64	//Secret, Feature Suffixes And The Closing >\n
 
 //Function Prototypes
-void handle_epoll();
 void dispatch_operation(int source_fd);
-void accept_clients(int server_fd);
-void handle_timers();
-void verify_protocol(int client_fd);
-void transfer_data(int source);
-void unwritten_data(int source_fd);
 void handle_bash(char *slave_name);
+int spawn_bash(char *slave_name);
 void terminate_client(int client_fd, int master_fd, int mark_terminated);
-void *allocate_client_memory(size_t size);
 
-int create_socket();
-int create_pty_pair(int client_fd, char *slave_name);
+int create_pty_pair(char *slave_name);
+int open_shell(char *slave_name, int *warm);
+int start_bash(int client_fd, int master_fd, char *slave_name);
 int init_client(int client_fd); 
-int send_protocol(int client_fd);
-int add_to_epoll(int source_fd);
-int rearm_epoll(int source_fd, int in_or_out);
-int init_client_obj(int client_fd);
-int create_timer();
+int add_to_epoll(int epoll_fd, int source_fd, uint32_t events);
+int rearm_epoll(int epoll_fd, int source_fd, uint32_t events);
+int init_client_obj(int client_fd, int node, uint16_t home);
 
 typedef enum {NEW, ESTABLISHED, UNWRITTEN, TERMINATED} Status;
+typedef enum {TIMER_HANDSHAKE, TIMER_SESSION} Timer_Kind;
+typedef enum {ENGINE_EPOLL, ENGINE_URING} Io_Engine;
+typedef enum {LAUNCH_SPAWN, LAUNCH_FORK} Launch_Mode;
+typedef enum {OP_ACCEPT = 1, OP_POLL, OP_READ, OP_WRITE, OP_CANCEL} Uring_Op;
+typedef enum {HANDSHAKE_PARTIAL, HANDSHAKE_COMPLETE, HANDSHAKE_INVALID} Handshake_Status;
+
+//Completion Tags Carry The Slot, Its Generation And The Buffer Being Written
+#define URING_DATA(op, flow, bid, slot, gen) (((uint64_t) (gen) << 48) | ((uint64_t) (flow) << 44) | \
+	((uint64_t) (op) << 40) | ((uint64_t) (bid) << 24) | (uint64_t) (slot))
+#define DATA_SLOT(data) ((uint32_t) ((data) & 0xFFFFFF))
+#define DATA_BID(data) ((unsigned) (((data) >> 24) & 0xFFFF))
+#define DATA_OP(data) ((int) (((data) >> 40) & 0xF))
+#define DATA_FLOW(data) ((int) (((data) >> 44) & 0x1))
+#define DATA_GEN(data) ((uint16_t) ((data) >> 48))
+
+typedef struct reactor_t{
+	pthread_t thread;
+	int epoll_fd;
+	int server_fd;
+	Timer_Wheel wheel;	//Handshake, Idle And Write Stall Timeouts
+	Uring uring;		//Completion Engine When Started With -U
+	struct client_t *starved;	//Sessions Whose Reads Found No Provided Buffer
+	int flush_fd;		//Deadline For Coalesced PTY Output, -1 Without Coalescing
+	pthread_mutex_t flush_lock;
+	struct client_t *held;	//Sessions Holding PTY Output Until The Deadline
+	int cpu;			//CPU The Loop Is Pinned To, -1 Without Placement
+	int node;			//NUMA Node Its Sessions Are Allocated From
+} Reactor;
 
 typedef struct client_t{
-	char *unwritten;
-	int unwritten_num;
+	_Alignas(CACHE_LINE) pthread_mutex_t lock;	//Slots Never Share A Cache Line
+	uint16_t generation;	//Survives Recycling So Stale Completions Are Dropped
+	uint16_t home;		//Pool Worker Plus One Owning The Session, Zero When Unplaced
+	atomic_int rerun;	//Edge Triggered Events That Found The Session Busy
+	atomic_int masters_fired;	//A PTY Master Entry Was Marked Fired Since The Last Multiplexed Pass
+	Reactor *reactor;	//Event Loop Owning Both Session Descriptors
+	Coro resume;		//Where session_main Continues, Zero Before The Handshake
+	Relay to_pty;		//Socket To PTY Master Direction
+	Relay to_socket;	//PTY Master To Socket Direction
+	Wheel_Timer timer;
+	uint64_t last_activity;	//Wheel Tick Of The Last Relay Pass
+	uint64_t stalled_since;	//Wheel Tick The Session Became UNWRITTEN
+	uint64_t accepted_at;	//Nanoseconds, For The Handshake Duration Metric
+	uint32_t client_events;
+	uint32_t master_events;
 	int client_fd;
 	int master_fd;
 	Status state;
+	struct client_t *starved_next;
+	uint32_t flow_length[URING_FLOWS];	//Bytes Read Into Each Direction's Buffer
+	uint32_t flow_sent[URING_FLOWS];	//Bytes Of That Buffer Already Written
+	uint8_t starved_flows;
+	struct client_t *held_next;
+	struct client_t **held_pprev;	//NULL While Off The Reactor's Held List
+	uint64_t held_since;	//Nanoseconds, Oldest Output Still Held Back
+	uint64_t last_input;	//Nanoseconds, Last Keystrokes Relayed To The PTY
+	uint8_t flushing;		//Deadline Passed So The Next Pass Writes Everything
+	uint8_t compressed;		//Both Directions Carry zstd Streams On The Socket
+	uint8_t handshake_length;
+	char handshake[HANDSHAKE_MAX];	//Secret Line Accumulated Across Events
+	Channel_Set *channels;	//Shells Multiplexed Over The Socket, NULL For A Single Shell
 } Client;
 
 typedef struct linked_list_t{
@@ -96,16 +173,187 @@ typedef struct linked_list_t{
 	struct linked_list_t *next;
 } Linked_Memory;
 
+//Client Memory Function Prototypes
+int init_client_memory(size_t capacity);
+Client *allocate_client_memory(int node);
+void release_client_memory(Client *client);
+int client_node(Client *client);
+Client *session_client(int fd);
+void set_client_state(Client *client, Status state);
+
+//Reactor Function Prototypes
+void handle_epoll(Reactor *reactor);
+void *run_reactor(void *arg);
+void dispatch_event(Reactor *reactor, int source_fd);
+tpool_lane_t classify_event(Reactor *reactor, int source_fd, uint32_t events);
+void run_session(Client *client, int source_fd);
+void resume_session(Client *client, int source_fd);
+Coro_Status session_main(Client *client, int source_fd);
+void accept_clients(Reactor *reactor);
+void handle_timers(Reactor *reactor);
+void expire_client(Client *client);
+int claim_client_timer(Wheel_Timer *timer);
+int init_reactor(Reactor *reactor);
+int create_socket(Reactor *reactor);
+int send_protocol(Reactor *reactor, int client_fd);
+int admit_client(Reactor *reactor, int client_fd);
+int place_client(Reactor *reactor, int client_fd, uint16_t *home);
+void reject_client(int client_fd);
+
+//io_uring Engine Function Prototypes
+void *run_uring(void *arg);
+void complete_uring(Reactor *reactor, struct io_uring_cqe *cqe);
+void uring_read_done(Client *client, int flow, struct io_uring_cqe *cqe);
+void uring_write_done(Client *client, int flow, unsigned bid, int result);
+void uring_starve(Client *client, int flow);
+void uring_feed_starved(Reactor *reactor);
+void uring_cancel_session(Client *client);
+int uring_watch(Reactor *reactor, int source_fd, uint32_t events);
+int uring_start_relay(Client *client);
+int uring_read_flow(Client *client, int flow);
+int uring_write_flow(Client *client, int flow, unsigned bid);
+int uring_arm_accept(Reactor *reactor);
+uint64_t uring_data(Client *client, Uring_Op op, int flow, unsigned bid);
+
+//Handshake Function Prototypes
+int await_handshake(Client *client);
+int start_session(Client *client);
+Handshake_Status read_handshake(Client *client);
+Handshake_Status scan_handshake(const char *line, size_t length);
+int handshake_feature(const char *line, size_t length, const char *feature);
+
+//Multiplexed Session Function Prototypes
+int mux_session(Client *client, int source_fd);
+void mark_fired(Client *client, int source_fd);
+void collect_fired(Client *client);
+int mux_frame(Client *client, const Mux_Frame *frame);
+int pump_channel(Client *client, Channel *channel, int source_fd);
+int open_channel(Client *client, uint16_t id, uint32_t credit);
+int close_channel(Client *client, Channel *channel, int notify);
+void close_channels(Client *client);
+
+//Relay Function Prototypes
+int relay_session(Client *client, int source_fd);
+void note_stall(Client *client);
+void mark_bulk(Client *client);
+size_t coalesce_limit(Client *client);
+void tune_compression(Client *client);
+void hold_output(Client *client);
+void release_output(Client *client);
+void flush_held(Reactor *reactor);
+int arm_flush(Reactor *reactor);
 
 //Instance Variables
-int epoll_fd, timer_epoll_fd, server_fd;
+Reactor *reactors;
+int reactor_count = 0;	//Zero Selects The Single Dispatcher And Thread Pool
+tpool_mode_t pool_mode = TPOOL_SHARED;
+int pool_min = 0, pool_max = 0;	//Zero Lets The Pool Size Itself From The CPU Count
+uint64_t pool_wait_ns = 0;
 int bash_pid;
-int fd_pairs[MAX_CLIENTS * 2 + 5];
-int clock_pairs[MAX_CLIENTS * 2 + 5];
-Client **client_pairs;
+size_t relay_capacity = RING_DEFAULT_CAPACITY;
+Relay_Mode relay_mode = RELAY_SPLICE;
+Io_Engine io_engine = ENGINE_EPOLL;
+int edge_triggered = 0;	//Register Once With EPOLLET Instead Of Rearming EPOLLONESHOT
+char *stats_path = NULL;	//Unix Socket Serving Prometheus Text, Off When NULL
+int shell_pool_size = 0;	//Warm Shells Kept By The Helper, Zero Forks Per Login
+Launch_Mode launch_mode = LAUNCH_SPAWN;
+extern char **environ;
+uint64_t idle_ticks = 0;	//Zero Disables The Idle Session Timeout
+uint64_t coalesce_ns = COALESCE_MICROSECONDS * 1000ull;	//Zero Writes PTY Output At Once
+uint64_t stall_ticks;
+int listen_backlog = LISTEN_BACKLOG;
+int defer_accept = 0;	//Seconds To Wait For Client Data Before Accepting, Zero Disables
+int max_handshakes = MAX_PENDING_HANDSHAKES;
+atomic_int pending_handshakes;	//Admitted Clients That Have Not Sent The Secret Yet
+int placement = 0;	//Pin Threads And Allocate Sessions On Their Owner's NUMA Node
+
+//Preallocated Client Slab And One Free List Per NUMA Node Partition
+Client *client_slab;
+Linked_Memory *memory_nodes;
+Linked_Memory *free_memory[TOPOLOGY_MAX_NODES];
+pthread_mutex_t free_memory_mtx[TOPOLOGY_MAX_NODES];
+int slab_partitions = 1;
+size_t partition_slots;
+size_t client_capacity = MAX_CLIENTS;
 
 
-int main(){
+int main(int argc, char *argv[]){
+	//Parse Command Line Options
+	int option;
+	stall_ticks = wheel_ticks(STALL_TIMER_AMOUNT);
+	relay_set_budget((size_t) BUFFER_BUDGET_MB << 20);
+	while((option = getopt(argc, argv, "A:B:C:D:EF:G:K:L:M:NP:Q:R:ST:UW:b:c:")) != -1){
+		switch(option){
+			case 'A':	//Unverified Clients Allowed Before New Ones Are Turned Away
+				max_handshakes = atoi(optarg);
+				break;
+			case 'B':	//Per Direction Relay Buffer Capacity In Bytes
+				relay_capacity = strtoul(optarg, NULL, 10);
+				break;
+			case 'C':	//Microseconds Small PTY Output May Wait To Be Coalesced
+				coalesce_ns = strtoull(optarg, NULL, 10) * 1000;
+				break;
+			case 'D':	//TCP_DEFER_ACCEPT Seconds For Clients That Send Before Reading
+				defer_accept = atoi(optarg);
+				break;
+			case 'E':	//Edge Triggered Registration Without Per Event Rearming
+				edge_triggered = 1;
+				break;
+			case 'F':	//Start Shells With posix_spawn Or A Full fork
+				launch_mode = strcmp(optarg, "fork") == 0 ? LAUNCH_FORK : LAUNCH_SPAWN;
+				break;
+			case 'G':	//Megabytes All Sessions May Hold Pending Before The Heaviest Pause
+				relay_set_budget(strtoull(optarg, NULL, 10) << 20);
+				break;
+			case 'K':	//Thread Pool Worker Floor And Ceiling As min:max
+				if(sscanf(optarg, "%d:%d", &pool_min, &pool_max) != 2){
+					pool_max = pool_min;
+				}
+				break;
+			case 'M':	//Unix Domain Stats Socket Path
+				stats_path = optarg;
+				break;
+			case 'N':	//Topology Aware Pinning And NUMA Local Session Memory
+				placement = 1;
+				break;
+			case 'P':	//Pre-Forked Shells Waiting On Their PTYs
+				shell_pool_size = atoi(optarg);
+				break;
+			case 'Q':	//Microseconds Of Queue Wait That Add A Pool Worker
+				pool_wait_ns = strtoull(optarg, NULL, 10) * 1000;
+				break;
+			case 'R':	//Zero Copy Splice Or Read/Write Copy Relaying
+				relay_mode = strcmp(optarg, "copy") == 0 ? RELAY_COPY : RELAY_SPLICE;
+				break;
+			case 'L':	//Number Of Independent Event Loops, Zero For Thread Pool Mode
+				reactor_count = atoi(optarg);
+				break;
+			case 'S':	//Per Worker Deques With Work Stealing
+				pool_mode = TPOOL_STEALING;
+				break;
+			case 'T':	//Seconds Without Traffic Before A Session Is Closed
+				idle_ticks = wheel_ticks(atoi(optarg));
+				break;
+			case 'U':	//Completion Based io_uring Engine Instead Of Epoll
+				io_engine = ENGINE_URING;
+				break;
+			case 'W':	//Seconds A Stalled Destination May Hold Pending Bytes
+				stall_ticks = wheel_ticks(atoi(optarg));
+				break;
+			case 'b':	//Listen Backlog Of Each Listener
+				listen_backlog = atoi(optarg);
+				break;
+			case 'c':	//Number Of Preallocated Client Slots
+				client_capacity = strtoul(optarg, NULL, 10);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-A max_handshakes] [-B relay_buffer_bytes] [-C coalesce_microseconds] [-D defer_seconds] [-E] [-F spawn|fork] [-G budget_megabytes] [-K min_workers:max_workers] [-Q wait_microseconds] [-R splice|copy]"
+						" [-L event_loops] [-M stats_socket] [-N] [-P pooled_shells] [-S] [-T idle_seconds] [-U] [-W stall_seconds]"
+						" [-b listen_backlog] [-c client_slots]\n", argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+	
 	//Eliminate Need for Child Proccess Collection
 	if(signal(SIGCHLD, SIG_IGN) == SIG_ERR){
 		perror("\nIn Function (Main), Failed To Set Up SIGCHLD Signal To Be Ignored In" 
@@ -115,79 +363,199 @@ int main(){
 		exit(EXIT_FAILURE);
 	}
 	
-	//Create Socket and Bind it with Corresponding Address
-	if(create_socket() == -1){
-		perror("\nIn Function (Main), Failed To Create Socket And Initialize Socket By"
-			   " Calling The Function (create_socket). NOTE: This Error Terminates"
-			   " The Server Program.\n");
+	//Writes To Sessions The Peer Already Closed Must Fail With EPIPE, Not Kill The Server
+	if(signal(SIGPIPE, SIG_IGN) == SIG_ERR){
+		perror("\nIn Function (Main), Failed To Set Up SIGPIPE Signal To Be Ignored."
+			   " NOTE: This Error Terminates The Server Program.\n");
 		exit(EXIT_FAILURE);
 	}
-			
-	//Make Epoll Unit to Transfer Data Between Clients And Server
-	if ((epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == -1) {
-		perror("\nIn Function (Main), Failed To Create An Epoll Unit. This Epoll Thread"
-			   " Is The Only Primary Thread In This Program That Does Not Run"
-			   " From The Thread Pool. NOTE: This Error Terminates The Server"
-			   " Program.\n");
-		exit(EXIT_FAILURE); 
-	}
-	
-	//Make Epoll Unit to Monitor Timers
-	if ((timer_epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == -1) {
-		perror("\nIn Function (Main), Failed To Create An Epoll Unit. This Epoll Unit Is"
-			   " Used For Client Timers. NOTE: This Error Terminates The Server"
-			   " Program.\n");
-		exit(EXIT_FAILURE); 
-	}
-	
-	//Initialize Client Pairs Pointer to Map Struct Addresses
-	if((client_pairs = malloc(sizeof(Client*) * MAX_CLIENTS + 5)) == NULL){
-		perror("\nIn Function (Main), Failed To Create Array To Hold Client Objects"
-			   " Addresses. NOTE: This Error Terminates The Server Program.\n");
+	
+	//Start The Shell Pool Helper Before The Slab And Threads Make Forking Expensive
+	if(shell_pool_size > 0 && shell_pool_start(shell_pool_size, handle_bash) == -1){
+		perror("\nIn Function (Main), Failed To Start The Shell Pool. NOTE: This"
+			   " Error Terminates The Server Program.\n");
 		exit(EXIT_FAILURE);
 	}
 	
-	//Add Epoll Timer File Descriptor to Epoll Unit
-	if(add_to_epoll(timer_epoll_fd) == -1){
-		perror("\nIn Function (main), Failed To Add Timer Epoll File Descriptor" 
-			   " To Epoll Unit. NOTE: This Error Results In The Server Terminating.");
+	//Initialize Session Table to Map Descriptors To Client Slots
+	if(session_table_init() == -1){
+		perror("\nIn Function (Main), Failed To Create Table To Map Descriptors To Client"
+			   " Objects. NOTE: This Error Terminates The Server Program.\n");
 		exit(EXIT_FAILURE);
 	}
 	
-	//Add Server File Descriptor to Epoll Unit
-	if(add_to_epoll(server_fd) == -1){
-		perror("\nIn Function (main), Failed To Add Server File Descriptor" 
-			   " To Epoll Unit. NOTE: This Error Results In The Server Terminating.");
+	//Read The CPU And Node Layout Before Anything Is Placed On It
+	if(placement && topology_init() == -1){
+		perror("\nIn Function (Main), Failed To Read The CPU Topology. NOTE: This"
+			   " Error Terminates The Server Program.\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	//Preallocate Every Client Slot Up Front
+	if(init_client_memory(client_capacity) == -1){
+		perror("\nIn Function (Main), Failed To Preallocate Client Memory. NOTE: This"
+			   " Error Terminates The Server Program.\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	//A Ring Is Only Ever Submitted To By Its Own Loop So io_uring Needs Event Loops
+	if(io_engine == ENGINE_URING && reactor_count == 0){
+		reactor_count = 1;
+	}
+	
+	//Metrics Are Always Recorded, The Stats Socket Only Serves Them
+	if(stats_path != NULL && metrics_serve(stats_path, tpool_queue_depth, relay_buffered) == -1){
+		perror("\nIn Function (Main), Failed To Open The Stats Socket. NOTE: This"
+			   " Error Terminates The Server Program.\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	//Create One Listener And Epoll Unit Per Event Loop
+	int loops = reactor_count > 0 ? reactor_count : 1;
+	if((reactors = calloc(loops, sizeof(Reactor))) == NULL){
+		perror("\nIn Function (Main), Failed To Allocate Event Loops. NOTE: This Error"
+			   " Terminates The Server Program.\n");
+		exit(EXIT_FAILURE);
+	}
+	for(int index = 0; index < loops; index++){
+		//Event Loops Spread Over The Topology Order, The Dispatcher Takes Its First CPU
+		reactors[index].cpu = placement ? topology_cpu(index) : -1;
+		reactors[index].node = placement ? topology_node(reactors[index].cpu) : 0;
+		if(init_reactor(&reactors[index]) == -1){
+			perror("\nIn Function (Main), Failed To Initialize Event Loop. NOTE: This"
+				   " Error Terminates The Server Program.\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+	
+	//The Main Thread Runs The First Loop Or The Dispatcher On Its Own CPU
+	if(placement && topology_pin(NULL, reactors[0].cpu) == -1){
+		perror("\nIn Function (Main), Failed To Pin The Main Event Loop. NOTE: This"
+			   " Error Terminates The Server Program.\n");
 		exit(EXIT_FAILURE);
 	}
 	
-	//Call Function To Handle Epoll Selection
-	handle_epoll();
+	//Single Dispatcher Feeding The Thread Pool
+	if(reactor_count == 0){
+		handle_epoll(&reactors[0]);
+		exit(EXIT_FAILURE);
+	}
+	
+	//Every Event Loop Runs Its Own Sessions, The Main Thread Taking The First
+	void *(*run_loop)(void *) = io_engine == ENGINE_URING ? run_uring : run_reactor;
+	pthread_attr_t attr;
+	for(int index = 1; index < reactor_count; index++){
+		pthread_attr_init(&attr);
+		if((placement && topology_pin(&attr, reactors[index].cpu) == -1) ||
+		   pthread_create(&reactors[index].thread, &attr, run_loop, &reactors[index]) != 0){
+			perror("\nIn Function (Main), Failed To Start Event Loop Thread. NOTE: This"
+				   " Error Terminates The Server Program.\n");
+			exit(EXIT_FAILURE);
+		}
+		pthread_attr_destroy(&attr);
+	}
+	run_loop(&reactors[0]);
 	
 	exit(EXIT_FAILURE);
 }
 
 
-void handle_epoll(){
-	int ready, source_fd;
-	struct epoll_event evlist[20];
+int init_reactor(Reactor *reactor){
+	//Create Socket and Bind it with Corresponding Address
+	if(create_socket(reactor) == -1){
+		perror("\nIn Function (init_reactor), Failed To Create Socket And Initialize Socket By"
+			   " Calling The Function (create_socket). NOTE: This Error Exits The"
+			   " Corresponding Function.\n");
+		return -1;
+	}
+			
+	//Make Timer Wheel to Monitor Client Timeouts
+	if(wheel_init(&reactor->wheel) == -1){
+		perror("\nIn Function (init_reactor), Failed To Create The Timer Wheel Used For"
+			   " Client Timeouts. NOTE: This Error Exits The Corresponding Function.\n");
+		return -1;
+	}
+	
+	//The io_uring Engine Takes The Place Of The Epoll Unit
+	reactor->flush_fd = -1;
+	pthread_mutex_init(&reactor->flush_lock, NULL);
+	if(io_engine == ENGINE_URING){
+		reactor->epoll_fd = -1;
+		unsigned buffers = client_capacity * URING_FLOWS < URING_BUFFERS ?
+						   client_capacity * URING_FLOWS : URING_BUFFERS;
+		if(uring_init(&reactor->uring, URING_ENTRIES, buffers, relay_capacity) == -1){
+			perror("\nIn Function (init_reactor), Failed To Create The io_uring Instance."
+				   " NOTE: This Error Exits The Corresponding Function.\n");
+			return -1;
+		}
+		return 0;
+	}
+	
+	//Make Epoll Unit to Transfer Data Between Clients And Server
+	if ((reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == -1) {
+		perror("\nIn Function (init_reactor), Failed To Create An Epoll Unit. This Epoll"
+			   " Unit Carries Every Session Accepted By The Event Loop. NOTE: This Error"
+			   " Exits The Corresponding Function.\n");
+		return -1;
+	}
+	
+	//Add Timer Wheel File Descriptor to Epoll Unit
+	if(add_to_epoll(reactor->epoll_fd, reactor->wheel.timer_fd, REARM_IN) == -1){
+		perror("\nIn Function (init_reactor), Failed To Add Timer Wheel File Descriptor" 
+			   " To Epoll Unit. NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	
+	//Add Server File Descriptor to Epoll Unit
+	if(add_to_epoll(reactor->epoll_fd, reactor->server_fd, REARM_IN) == -1){
+		perror("\nIn Function (init_reactor), Failed To Add Server File Descriptor" 
+			   " To Epoll Unit. NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	
+	//One Deadline Per Event Loop Flushes Every Session Holding Output
+	if(coalesce_ns > 0){
+		if((reactor->flush_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK)) == -1 ||
+		   add_to_epoll(reactor->epoll_fd, reactor->flush_fd, REARM_IN) == -1){
+			perror("\nIn Function (init_reactor), Failed To Create The Output Flush Timer."
+				   " NOTE: This Error Exits The Corresponding Function.");
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+void handle_epoll(Reactor *reactor){
+	int ready;
+	struct epoll_event evlist[EPOLL_BATCH];
+	int batch[EPOLL_BATCH];
+	unsigned int affinities[EPOLL_BATCH];
+	tpool_lane_t lanes[EPOLL_BATCH];
 	
-	//Initialize Thread Pool Function
-	tpool_init(dispatch_operation);
+	//Initialize Thread Pool Function, Free To Grow While Workers Block In fork
+	tpool_set_elastic(pool_min, pool_max, pool_wait_ns);
+	if(tpool_init(dispatch_operation, pool_mode, placement) == -1){
+		perror("\nIn Function (handle_epoll), Failed To Start The Thread Pool. NOTE:"
+			   " This Error Results In The Server Terminating.\n");
+		return;
+	}
 
 	//Loop and Find FD that are ready for IO
-	while ((ready = epoll_wait(epoll_fd, evlist, MAX_CLIENTS * 2, -1)) > 0){
+	while ((ready = epoll_wait(reactor->epoll_fd, evlist, EPOLL_BATCH, -1)) >= 0 || errno == EINTR){
 		for (int i = 0; i < ready; i++) {
-	
-			//Check if Epoll was Invalid
-			if (evlist[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)){
-				terminate_client(evlist[i].data.fd, fd_pairs[evlist[i].data.fd], MARK);
-				
-			}else if ((evlist[i].events & EPOLLIN) || (evlist[i].events & EPOLLOUT)){
-				//Data is ready to read so transfer:
-				source_fd = evlist[i].data.fd;
-				tpool_add_task(source_fd);
-			}
+			//Hangups Are Handed To A Worker So Teardown Happens Under The Client Lock
+			int source_fd = evlist[i].data.fd;
+			batch[i] = source_fd;
+			
+			//Both Descriptors Of A Session Share One Affinity Key
+			affinities[i] = session_affinity(source_fd);
+			lanes[i] = classify_event(reactor, source_fd, evlist[i].events);
+		}
+		
+		//Hand The Whole Result Set To The Pool In One Reservation
+		if(ready > 0){
+			tpool_add_affine_tasks(batch, affinities, lanes, ready);
 		}
 	}
 	perror("\nIn Function (handle_epoll - Epoll Loop). NOTE An Error Occurred"
@@ -196,258 +564,995 @@ void handle_epoll(){
 }
 
 
-void dispatch_operation(int source_fd){
-	if(source_fd == server_fd){ //Accept Clients State
-		accept_clients(source_fd);
-		
-	}else if(source_fd == timer_epoll_fd){
-		handle_timers();
-		
-	}else{
-		switch(client_pairs[source_fd]->state){ //Client Object Case	
-			case NEW:
-				verify_protocol(source_fd);
-				break;
-				
-			case ESTABLISHED:
-				transfer_data(source_fd);
-				break;
-				
-			case UNWRITTEN:
-				unwritten_data(source_fd);
-				break;
-				
-			case TERMINATED:
-				perror("Terminated Case...........................");
-				break;
-				
-			default:
-				perror("Something");
+tpool_lane_t classify_event(Reactor *reactor, int source_fd, uint32_t events){
+	Session_Entry *entry, *peer;
+	
+	//New Connections And Unverified Sessions Lead To fork, So They Queue Apart
+	if(source_fd == reactor->server_fd){
+		return TPOOL_SETUP;
+	}
+	if((entry = session_lookup(source_fd)) == NULL || entry->slot == SESSION_UNMAPPED){
+		return TPOOL_INTERACTIVE;	//Timers, And Events Racing A Teardown
+	}
+	if(entry->state == NEW){
+		return TPOOL_SETUP;
+	}
+	
+	//Reads Follow The Descriptor's Own Traffic, Writes The Traffic Being Drained Into It
+	if(!(events & EPOLLIN) && (peer = session_lookup(entry->peer_fd)) != NULL){
+		entry = peer;
+	}
+	return entry->bulk ? TPOOL_BULK : TPOOL_INTERACTIVE;
+}
+
+
+void *run_reactor(void *arg){
+	Reactor *reactor = arg;
+	int ready;
+	struct epoll_event evlist[EPOLL_BATCH];
+	
+	//Loop Handles Its Own Events Inline Without Crossing Threads
+	while ((ready = epoll_wait(reactor->epoll_fd, evlist, EPOLL_BATCH, -1)) >= 0 || errno == EINTR){
+		for (int i = 0; i < ready; i++) {
+			dispatch_event(reactor, evlist[i].data.fd);
 		}
 	}
+	perror("\nIn Function (run_reactor - Epoll Loop). NOTE An Error Occurred"
+		   " Causing The Event Loop To Terminate Causing The Server To"
+		   " Crash.\n");
+	exit(EXIT_FAILURE);
 }
 
 
-void accept_clients(int server_fd){
-	struct sockaddr_in client_address;
-    socklen_t client_len = sizeof(client_address);
-	int client_fd;
+void dispatch_operation(int source_fd){
+	//Thread Pool Mode Runs A Single Event Loop
+	dispatch_event(&reactors[0], source_fd);
+}
+
+
+void dispatch_event(Reactor *reactor, int source_fd){
+	Client *client;
 	
-	//Server Loop to Accept Clients
-    while((client_fd = accept4(server_fd, (struct sockaddr *) &client_address,
-							   &client_len, SOCK_CLOEXEC | SOCK_NONBLOCK)) > 0){
+	if(source_fd == reactor->server_fd){ //Accept Clients State
+		accept_clients(reactor);
 		
-		//Initialize Client Struct
-		if(init_client_obj(client_fd) == -1){
-			perror("\nIn Function (accept_clients), Error Initializing Client"
-				   " Struct. NOTE: This Ends The Client Connection.\n");
-			terminate_client(client_fd, -1, NOT_MARK);
-			return;
-		}
+	}else if(source_fd == reactor->wheel.timer_fd){
+		handle_timers(reactor);
 		
-		//Add Client File Descriptor to Epoll Unit
-		if(add_to_epoll(client_fd) == -1){
-			perror("\nIn Function (accept_clients), Failed To Add Client File Descriptor" 
-				   " To Epoll Unit. NOTE: This Error Results In The Client Terminating.");
-			terminate_client(client_fd, -1, MARK);
+	}else if(source_fd == reactor->flush_fd){
+		flush_held(reactor);
+		
+	}else{
+		//Serialize Socket And PTY Master Events Of The Same Session
+		if((client = session_client(source_fd)) == NULL){
 			return;
 		}
 		
-		//Send First Part Of Protocol Verification
-		if(send_protocol(client_fd) == -1){
-			perror("\nIn Function (accept_clients), Error Sending Rembash"
-				   " Protocol. NOTE: This Ends The Client Connection.\n");
-			terminate_client(client_fd, -1, MARK);
+		//Edge Triggered Events Never Wait On A Busy Session, Its Owner Runs Again
+		if(edge_triggered){
+			mark_fired(client, source_fd);
+			atomic_store(&client->rerun, 1);
+			while(atomic_load(&client->rerun) && pthread_mutex_trylock(&client->lock) == 0){
+				atomic_store(&client->rerun, 0);
+				run_session(client, source_fd);
+			}
 			return;
 		}
-		
-		//Rearm Epoll For Input
-		if(rearm_epoll(server_fd, REARM_IN) == -1){
-			perror("\nIn Function (accept_clients), Error Rearming Server File"
-				   " Descriptor For Epoll Loop. NOTE: This Terminates The Client"
-				   " Connection.\n");
-			terminate_client(client_fd, -1, MARK);
+		pthread_mutex_lock(&client->lock);
+		run_session(client, source_fd);
+	}
+}
+
+
+void run_session(Client *client, int source_fd){
+	//The Slot May Have Been Recycled While This Event Waited
+	if(session_client(source_fd) != client){
+		pthread_mutex_unlock(&client->lock);
+		return;
+	}
+	metrics_add(client->state == NEW ? METRIC_EVENTS_NEW :
+				client->state == UNWRITTEN ? METRIC_EVENTS_UNWRITTEN : METRIC_EVENTS_ESTABLISHED, 1);
+	resume_session(client, source_fd);
+}
+
+
+void resume_session(Client *client, int source_fd){
+	//A Suspended Session Still Holds Its Lock, A Finished One Was Torn Down With It
+	if(session_main(client, source_fd) == CORO_SUSPENDED){
+		pthread_mutex_unlock(&client->lock);
+	}
+}
+
+
+Coro_Status session_main(Client *client, int source_fd){
+	const char * const error_message = "<error>\n";
+	Handshake_Status status;
+	
+	//Each Await Returns To The Event Loop, The Session's Next Event Continues Below It
+	CORO_BEGIN(&client->resume);
+	
+	//Secret Message Recieving, Whatever Has Arrived So Far, The Handshake Timer Bounds It
+	while((status = read_handshake(client)) == HANDSHAKE_PARTIAL){
+		if(await_handshake(client) == -1){
+			terminate_client(client->client_fd, -1, MARK);
+			CORO_EXIT(&client->resume);
 		}
+		CORO_AWAIT(&client->resume);
 	}
+	if(status == HANDSHAKE_INVALID){
+		write(client->client_fd, error_message, strlen(error_message));
+		perror("\nIn Function (session_main), Incorrect Secret Message." 
+			   " NOTE: This Error Closes The Client.\n");
+		terminate_client(client->client_fd, -1, MARK);
+		CORO_EXIT(&client->resume);
+	}
+	if(start_session(client) == -1){
+		CORO_EXIT(&client->resume);	//Client Termination Handled In start_session
+	}
+	
+	//One Relay Pass Over Both Directions, Or Over Every Channel With Work, Per Event Until
+	//The Session Closes. The Completion Engine Relays From Its Own Callbacks So Its Sessions Rest Here
+	for(;;){
+		CORO_AWAIT(&client->resume);
+		if((client->channels != NULL ? mux_session(client, source_fd) : relay_session(client, source_fd)) == -1){
+			CORO_EXIT(&client->resume);
+		}
+	}
+	CORO_END(&client->resume);
 }
 
 
-void handle_timers(int timer_epoll_fd){
-	int ready, source_fd;
-	struct epoll_event evlist[20];
+void accept_clients(Reactor *reactor){
+	struct sockaddr_in client_address;
+    socklen_t client_len = sizeof(client_address);
+	int client_fd;
 	
-	//Loop and Find FD that are ready for IO
-	if((ready = epoll_wait(timer_epoll_fd, evlist, MAX_CLIENTS * 2, -1)) > 0){
-		for (int i = 0; i < ready; i++) {
-			
-			perror("Timer Expired");
-			source_fd = evlist[i].data.fd;
-			terminate_client(clock_pairs[source_fd], -1, MARK);
-			close(source_fd);
+	int accepted;
+	
+	//Server Loop to Accept Clients, Bounded So A Storm Cannot Starve Established Sessions
+	for(accepted = 0; accepted < ACCEPT_BATCH; accepted++){
+		client_len = sizeof(client_address);
+		if((client_fd = accept4(reactor->server_fd, (struct sockaddr *) &client_address,
+								&client_len, SOCK_CLOEXEC | SOCK_NONBLOCK)) == -1){
+			//Connections Reset While Queued Only Cost Themselves
+			if(errno == ECONNABORTED || errno == EPROTO || errno == EINTR){
+				continue;
+			}
+			break;
 		}
+		
+		//A Client That Fails Admission Never Stops The Rest Of The Queue
+		admit_client(reactor, client_fd);
 	}
 	
-	//Rearm Epoll For Input
-	if(rearm_epoll(timer_epoll_fd, REARM_IN) == -1){
-		perror("\nIn Function (handle_timers), Error Rearming Epoll Timer File"
-			   " Descriptor For Epoll Loop. NOTE: This Terminates The Client"
-			   " Connection.\n");
+	//A Full Batch Rearms Even Edge Triggered Listeners, Which Reports The Rest Of The Queue Again
+	if((!edge_triggered || accepted == ACCEPT_BATCH) &&
+	   rearm_epoll(reactor->epoll_fd, reactor->server_fd, REARM_IN) == -1){
+		perror("\nIn Function (accept_clients), Error Rearming Server File"
+			   " Descriptor For Epoll Loop. NOTE: This Stops New Connections On"
+			   " This Event Loop.\n");
 	}
 }
 
 
-void verify_protocol(int client_fd){
-	//Variables for Reading and Writing
-	char *message_buffer;
-	const char * const error_message = "<error>\n";
-	const char * const ok_message = "<ok>\n";
+int admit_client(Reactor *reactor, int client_fd){
+	//Past The Handshake Limit Clients Are Turned Away Before They Cost A Slot
+	if(atomic_load_explicit(&pending_handshakes, memory_order_relaxed) >= max_handshakes){
+		reject_client(client_fd);
+		return -1;
+	}
 	
-	//Secret Message Recieving 
-	message_buffer = readline(client_fd);
+	//Initialize Client Struct On The Node That Will Run The Session
+	uint16_t home;
+	int node = place_client(reactor, client_fd, &home);
+	if(init_client_obj(client_fd, node, home) == -1){
+		perror("\nIn Function (admit_client), Error Initializing Client"
+			   " Struct. NOTE: This Ends The Client Connection.\n");
+		reject_client(client_fd);
+		return -1;
+	}
 	
-	//Verify Correct Secret Message
-	if(strcmp("<" SECRET ">\n", message_buffer) != 0){
-		write(client_fd, error_message, strlen(error_message));
-		perror("\nIn Function (verify_protocol), Incorrect Secret Message." 
-			   " NOTE: This Error Closes The Client.\n");
+	//Client Comes Back Locked Until Its Protocol Greeting Is Sent
+	Client *client = session_client(client_fd);
+	client->reactor = reactor;
+	
+	//Watch Client File Descriptor For The Secret Message
+	int watched = io_engine == ENGINE_URING ? uring_watch(reactor, client_fd, REARM_IN) :
+											  add_to_epoll(reactor->epoll_fd, client_fd, REARM_IN);
+	if(watched == -1){
+		perror("\nIn Function (admit_client), Failed To Watch Client File Descriptor" 
+			   " For Input. NOTE: This Error Results In The Client Terminating.");
 		terminate_client(client_fd, -1, MARK);
+		return -1;
+	}
+	
+	//Send First Part Of Protocol Verification
+	if(send_protocol(reactor, client_fd) == -1){
+		perror("\nIn Function (admit_client), Error Sending Rembash"
+			   " Protocol. NOTE: This Ends The Client Connection.\n");
+		terminate_client(client_fd, -1, MARK);
+		return -1;
+	}
+	metrics_add(METRIC_ACCEPTED, 1);
+	pthread_mutex_unlock(&client->lock);
+	return 0;
+}
+
+
+int place_client(Reactor *reactor, int client_fd, uint16_t *home){
+	int cpu;
+	socklen_t length = sizeof(cpu);
+	
+	*home = 0;
+	if(!placement){
+		return 0;
+	}
+	
+	//Each Event Loop Owns Its Sessions, And Its Listener Already Prefers Its CPU
+	if(reactor_count > 0){
+		return reactor->node;
+	}
+	
+	//The Pool Follows The CPU That Took The Connection's Receive Softirq
+	if(getsockopt(client_fd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &length) == -1 || cpu < 0){
+		cpu = sched_getcpu();
+	}
+	if(pool_mode == TPOOL_STEALING){
+		int worker = tpool_worker_on(cpu);
+		*home = worker == -1 ? 0 : worker + 1;
+	}
+	return topology_node(cpu);
+}
+
+
+void reject_client(int client_fd){
+	const char * const busy_message = "<busy>\n";
+	
+	//One Best Effort Write Into An Empty Send Buffer, Then The Connection Is Gone
+	write(client_fd, busy_message, strlen(busy_message));
+	metrics_add(METRIC_REJECTED, 1);
+	terminate_client(client_fd, -1, NOT_MARK);
+}
+
+
+void handle_timers(Reactor *reactor){
+	Wheel_Timer *timer, *next;
+	
+	//Advance The Wheel And Take Every Client Whose Deadline Passed
+	for(timer = wheel_advance(&reactor->wheel, claim_client_timer); timer != NULL; timer = next){
+		next = timer->next;
+		expire_client((Client *) ((char *) timer - offsetof(Client, timer)));
+	}
+	
+	//Rearm Epoll For Input
+	int rearmed = 0;
+	if(io_engine == ENGINE_URING){
+		rearmed = uring_watch(reactor, reactor->wheel.timer_fd, REARM_IN);
+	}else if(!edge_triggered){
+		rearmed = rearm_epoll(reactor->epoll_fd, reactor->wheel.timer_fd, REARM_IN);
+	}
+	if(rearmed == -1){
+		perror("\nIn Function (handle_timers), Error Rearming Timer Wheel File"
+			   " Descriptor For Epoll Loop. NOTE: This Stops Client Timeouts On"
+			   " This Event Loop.\n");
+	}
+}
+
+
+int claim_client_timer(Wheel_Timer *timer){
+	Client *client = (Client *) ((char *) timer - offsetof(Client, timer));
+	
+	//Never Wait On A Client Under The Wheel Lock, Busy Clients Retry Next Tick
+	return pthread_mutex_trylock(&client->lock) == 0 ? 0 : -1;
+}
+
+
+void expire_client(Client *client){
+	Timer_Wheel *wheel = &client->reactor->wheel;
+	uint64_t now = wheel_now(wheel), deadline = UINT64_MAX;
+	
+	//Unverified Clients Get MAX_TIMER_AMOUNT Seconds To Send The Secret
+	if(client->timer.kind == TIMER_HANDSHAKE){
+		metrics_add(METRIC_HANDSHAKE_TIMEOUTS, 1);
+		perror("Timer Expired");
+		terminate_client(client->client_fd, client->master_fd, MARK);
 		return;
 	}
 	
-	//Disarm File Descriptor Timer
-	close(clock_pairs[client_fd]);
+	//Sessions Die When Idle Or When A Destination Stops Accepting Bytes
+	if(idle_ticks > 0 && now - client->last_activity >= idle_ticks){
+		metrics_add(METRIC_IDLE_TIMEOUTS, 1);
+		perror("Idle Timer Expired");
+		terminate_client(client->client_fd, client->master_fd, MARK);
+		return;
+	}
+	if(stall_ticks > 0 && client->state == UNWRITTEN && now - client->stalled_since >= stall_ticks){
+		metrics_add(METRIC_STALL_TIMEOUTS, 1);
+		perror("Write Stall Timer Expired");
+		terminate_client(client->client_fd, client->master_fd, MARK);
+		return;
+	}
+	
+	//Otherwise Sleep Until The Nearest Remaining Deadline
+	if(idle_ticks > 0){
+		deadline = client->last_activity + idle_ticks;
+	}
+	if(stall_ticks > 0 && client->state == UNWRITTEN && client->stalled_since + stall_ticks < deadline){
+		deadline = client->stalled_since + stall_ticks;
+	}
+	if(deadline != UINT64_MAX){
+		wheel_schedule(wheel, &client->timer, deadline - now);
+	}
+	pthread_mutex_unlock(&client->lock);
+	
+	//Edge Triggered Events That Arrived While The Wheel Held The Session Run Now
+	if(edge_triggered && atomic_load(&client->rerun)){
+		dispatch_event(client->reactor, client->client_fd);
+	}
+}
+
+
+int await_handshake(Client *client){
+	int rearmed = 0;
+	
+	//Edge Triggered Sockets Stay Armed, The Others Wait For The Rest Of The Line
+	if(io_engine == ENGINE_URING){
+		rearmed = uring_watch(client->reactor, client->client_fd, REARM_IN);
+	}else if(!edge_triggered){
+		rearmed = rearm_epoll(client->reactor->epoll_fd, client->client_fd, REARM_IN);
+	}
+	if(rearmed == -1){
+		perror("\nIn Function (await_handshake), Error Rearming Client File"
+			   " Descriptor For The Rest Of The Secret. NOTE: This Terminates The"
+			   " Client Connection.\n");
+		return -1;
+	}
+	return 0;
+}
+
+
+int start_session(Client *client){
+	const char *ok_message = "<ok>\n";
+	int client_fd = client->client_fd;
+	
+	//Multiplexing Clients Append +mux And Open Their Shells As Channels Afterwards
+	if(io_engine == ENGINE_EPOLL &&
+	   handshake_feature(client->handshake, client->handshake_length, MUX_FEATURE)){
+		if((client->channels = channel_set_create(client_node(client))) == NULL){
+			terminate_client(client_fd, -1, MARK);
+			return -1;
+		}
+		ok_message = "<ok" MUX_FEATURE ">\n";
+	
+	//Clients Asking For Compression Append +zstd, The Completion Engine Answers Plain
+	}else if(io_engine == ENGINE_EPOLL &&
+	   handshake_feature(client->handshake, client->handshake_length, "+zstd")){
+		client->compressed = 1;
+		ok_message = "<ok+zstd>\n";
+	}
+	
+	//Swap The Handshake Timeout For The Session Timeouts
+	client->timer.kind = TIMER_SESSION;
+	client->last_activity = wheel_now(&client->reactor->wheel);
+	if(idle_ticks > 0){
+		wheel_schedule(&client->reactor->wheel, &client->timer, idle_ticks);
+	}else{
+		wheel_cancel(&client->reactor->wheel, &client->timer);
+	}
 
-	//Final OK Message
-	if(write(client_fd, ok_message, strlen(ok_message)) < strlen(ok_message)){
-		perror("\nIn Function (verify_protocol), Error Sending OK Message"
+	//Final OK Message, A Failed Write Must Not Convert To A Huge Unsigned Count
+	size_t length = strlen(ok_message);
+	ssize_t written = write(client_fd, ok_message, length);
+	if(written == -1 || (size_t) written < length){
+		perror("\nIn Function (start_session), Error Sending OK Message"
 			   " Message To Client. NOTE This Error Causes The Client To Terminate.\n");
 		terminate_client(client_fd, -1, MARK);
-		return;
+		return -1;
 	}
 	
-	//Initialize Client
-	if(init_client(client_fd) == -1){
-		perror("\nIn Function (verify_protocol), Error Initalizing Client With PTY And"
+	//Initialize Client, A Multiplexed One Waits For Its First OPEN Frame Instead
+	if(client->channels == NULL && init_client(client_fd) == -1){
+		perror("\nIn Function (start_session), Error Initalizing Client With PTY And"
 			   " Bash Subprocess. NOTE: This Error Closes The Client.");
-		return; //Client Termination Handled In init_client Function
+		return -1; //Client Termination Handled In init_client Function
 	}
 	
-	//Rearm Epoll For Input
-	if(rearm_epoll(client_fd, REARM_IN) == -1){
-		perror("\nIn Function (verify_protocol), Error Rearming Client File"
+	//Mark Client Object as a Valid Client
+	set_client_state(client, ESTABLISHED);
+	metrics_observe(METRIC_HANDSHAKE, metrics_now() - client->accepted_at);
+	
+	//Completion Engine Keeps A Read Outstanding On Both Descriptors From Here On
+	if(io_engine == ENGINE_URING){
+		if(uring_start_relay(client) == -1){
+			terminate_client(client_fd, client->master_fd, MARK);
+			return -1;
+		}
+		return 0;
+	}
+	
+	//Rearm Epoll For Input, Edge Triggered Sockets Gain Write Interest Once Here
+	if(rearm_epoll(client->reactor->epoll_fd, client_fd, edge_triggered ? REARM_IN | REARM_OUT : REARM_IN) == -1){
+		perror("\nIn Function (start_session), Error Rearming Client File"
 			   " Descriptor For Epoll Loop. NOTE: This Terminates The Client"
 			   " Connection.\n");
-		terminate_client(client_fd, -1, MARK);
-		return;
+		terminate_client(client_fd, client->master_fd, MARK);
+		return -1;
+	}
+	client->client_events = REARM_IN;
+	return 0;
+}
+
+
+Handshake_Status read_handshake(Client *client){
+	size_t space = HANDSHAKE_MAX - client->handshake_length;
+	char *end = client->handshake + client->handshake_length;
+	ssize_t count;
+	
+	//Peek First So Bytes After The Secret Line Stay Queued For The Relay
+	if((count = recv(client->client_fd, end, space, MSG_PEEK)) <= 0){
+		return count < 0 && errno == EAGAIN ? HANDSHAKE_PARTIAL : HANDSHAKE_INVALID;
 	}
+	char *newline = memchr(end, '\n', count);
+	if(newline != NULL){
+		count = newline - end + 1;
+	}
+	if((count = recv(client->client_fd, end, count, 0)) <= 0){
+		return count < 0 && errno == EAGAIN ? HANDSHAKE_PARTIAL : HANDSHAKE_INVALID;
+	}
+	client->handshake_length += count;
+	return scan_handshake(client->handshake, client->handshake_length);
+}
+
+
+Handshake_Status scan_handshake(const char *line, size_t length){
+	size_t prefix = strlen(HANDSHAKE_PREFIX);
 	
-	//Mark Client Object as a Valid Client
-	client_pairs[client_fd]->state = ESTABLISHED;
+	//Every Byte So Far Must Still Be On The Way To <SECRET[+feature...]>\n
+	if(memcmp(line, HANDSHAKE_PREFIX, length < prefix ? length : prefix) != 0){
+		return HANDSHAKE_INVALID;
+	}
+	for(size_t index = prefix; index < length; index++){
+		char previous = line[index - 1], current = line[index];
+
+		if(previous == '>'){
+			return current == '\n' && index == length - 1 ? HANDSHAKE_COMPLETE : HANDSHAKE_INVALID;
+		}
+
+		//The Secret Ends At > Or +, Letters Only Inside A Token And Never An Empty One
+		if(current == '+' || current == '>'){
+			if(previous == '+'){
+				return HANDSHAKE_INVALID;
+			}
+		}else if(current < 'a' || current > 'z' || index == prefix){
+			return HANDSHAKE_INVALID;
+		}
+	}
+	
+	//A Line That Fills The Buffer Without Closing Can Never Be Valid
+	return length < HANDSHAKE_MAX ? HANDSHAKE_PARTIAL : HANDSHAKE_INVALID;
 }
 
 
-void transfer_data(int source_fd){
-	static char read_buffer[MAX_BUFF]; 
-	int chars_read = 0, chars_written = 0;
-		
-	//Read from File Descriptor
-	if((chars_read = read(source_fd, read_buffer, MAX_BUFF)) < 0){
-		perror("\nIn Function (transfer_data), Error Reading... NOTE: This Error Exits"
-			   " The Corresponding Function");
-		terminate_client(source_fd, fd_pairs[source_fd], MARK);
-		return;
+int handshake_feature(const char *line, size_t length, const char *feature){
+	size_t feature_length = strlen(feature);
+	
+	//Features Are +word Tokens Between The Secret And The Closing >
+	for(size_t index = strlen(HANDSHAKE_PREFIX); index + feature_length < length; index++){
+		if(line[index] == '+' && memcmp(line + index, feature, feature_length) == 0 &&
+		   (line[index + feature_length] == '+' || line[index + feature_length] == '>')){
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+int relay_session(Client *client, int source_fd){
+	Relay_Status inbound, outbound;
+	uint32_t client_events, master_events;
+	
+	//Pump Socket To PTY, Then PTY To Socket Held Back Unless The Session Looks Interactive
+	if((inbound = pump_relay(&client->to_pty)) == RELAY_CLOSED){
+		terminate_client(client->client_fd, client->master_fd, MARK);
+		return -1;
 	}
+	relay_hold(&client->to_socket, coalesce_limit(client));
+	if(client->compressed){
+		tune_compression(client);
+	}
+	if((outbound = pump_relay(&client->to_socket)) == RELAY_CLOSED){
+		terminate_client(client->client_fd, client->master_fd, MARK);
+		return -1;
+	}
+	if(outbound == RELAY_HELD){
+		hold_output(client);
+	}else if(client->held_pprev != NULL){
+		release_output(client);
+	}
+	mark_bulk(client);
+	metrics_add(METRIC_BYTES_TO_PTY, client->to_pty.moved);
+	metrics_add(METRIC_BYTES_TO_SOCKET, client->to_socket.moved);
+	metrics_add(METRIC_PARTIAL_WRITES, client->to_pty.partial_writes + client->to_socket.partial_writes);
+	metrics_add(METRIC_READ_PAUSES, client->to_pty.pauses + client->to_socket.pauses);
 	
-	//Write to File Descriptor
-	if((chars_written = write(fd_pairs[source_fd], read_buffer, chars_read))
-	   < chars_read){
+	//Bytes Left In Either Ring Mean A Destination Is Stalled, Unless They Are Only Held
+	Timer_Wheel *wheel = &client->reactor->wheel;
+	client->last_activity = wheel_now(wheel);
+	if(relay_pending(&client->to_pty) > 0 || (relay_pending(&client->to_socket) > 0 && outbound != RELAY_HELD)){
+		note_stall(client);
+	}else{
+		set_client_state(client, ESTABLISHED);
+	}
+	
+	//Edge Triggered Descriptors Stay Armed, A Yielded Pass Simply Runs Again
+	int yielded = (inbound == RELAY_YIELD || outbound == RELAY_YIELD);
+	if(edge_triggered){
+		if(yielded){
+			atomic_store(&client->rerun, 1);
+		}
+		return 0;
+	}
+	
+	//Interest Follows Ring Space For Reads And Pending Bytes For Writes
+	client_events = relay_events(&client->to_socket, &client->to_pty);
+	master_events = relay_events(&client->to_pty, &client->to_socket);
+	
+	//The Fired Descriptor And Any Yielded Pass Must Be Rearmed Even If Unchanged
+	if(source_fd == client->client_fd || yielded || client_events != client->client_events){
+		if(rearm_epoll(client->reactor->epoll_fd, client->client_fd, client_events) == -1){
+			perror("\nIn Function (relay_session), Error Rearming Client File Descriptor For"
+				   " Epoll Unit. NOTE: This Error Terminates The Client Connection.\n");
+			terminate_client(client->client_fd, client->master_fd, MARK);
+			return -1;
+		}
+		client->client_events = client_events;
+	}
+	if(source_fd == client->master_fd || yielded || master_events != client->master_events){
+		if(rearm_epoll(client->reactor->epoll_fd, client->master_fd, master_events) == -1){
+			perror("\nIn Function (relay_session), Error Rearming Master File Descriptor For"
+				   " Epoll Unit. NOTE: This Error Terminates The Client Connection.\n");
+			terminate_client(client->client_fd, client->master_fd, MARK);
+			return -1;
+		}
+		client->master_events = master_events;
+	}
+	return 0;
+}
+
+
+void mark_bulk(Client *client){
+	Session_Entry *entry;
+	
+	//Small Passes Are Keystrokes And Echoes, Large Ones Are Output Dumps Or Uploads
+	if((entry = session_lookup(client->client_fd)) != NULL){
+		entry->bulk = client->to_pty.moved >= BULK_PASS_BYTES;
+	}
+	if((entry = session_lookup(client->master_fd)) != NULL){
+		entry->bulk = client->to_socket.moved >= BULK_PASS_BYTES;
+	}
+}
+
+
+void note_stall(Client *client){
+	Timer_Wheel *wheel = &client->reactor->wheel;
+	
+	if(client->state != UNWRITTEN){
+		client->stalled_since = wheel_now(wheel);
 		
-		//Partial Write Case	
-		if(errno == EAGAIN){
-			client_pairs[source_fd]->unwritten = (read_buffer + chars_written);
-			client_pairs[source_fd]->unwritten_num = chars_read - chars_written;
-			client_pairs[source_fd]->state = UNWRITTEN;
-			
-			if(rearm_epoll(source_fd, REARM_OUT) == -1){
-				perror("\nIn Function (transfer_data), Error Rearming Source File Descriptor For"
-					   " Epoll Unit. NOTE: This Error Terminates The Client Connection.\n");
-				terminate_client(source_fd, fd_pairs[source_fd], MARK);
-				return;
+		//Pull The Session Timer In Only If It Would Fire After The Stall Deadline
+		if(stall_ticks > 0 && (client->timer.pprev == NULL ||
+		   client->timer.expires > client->stalled_since + stall_ticks)){
+			wheel_schedule(wheel, &client->timer, stall_ticks);
+		}
+	}
+	set_client_state(client, UNWRITTEN);
+}
+
+
+int mux_session(Client *client, int source_fd){
+	Channel_Set *set = client->channels;
+	Channel *channel;
+	Session_Entry *entry;
+	Mux_Frame frame;
+	ssize_t count;
+	int passes, parsed;
+	uint32_t client_events;
+	
+	//A Rerun May Carry Events Other Threads Left Behind, So Edge Triggered Passes Read The Marks
+	int socket_fired = (source_fd == client->client_fd);
+	if(edge_triggered){
+		socket_fired |= atomic_exchange(&session_lookup(client->client_fd)->fired, 0);
+		if(atomic_exchange(&client->masters_fired, 0)){
+			collect_fired(client);
+		}
+	}else if(!socket_fired && (entry = session_lookup(source_fd)) != NULL &&
+			 (channel = channel_find(set, source_fd, entry->channel)) != NULL){
+		channel_ready(set, channel);	//A PTY Master Firing Only Wakes Its Own Channel
+	}
+	
+	//The Socket Carries Frames, Read Until It Runs Dry A Bounded Number Of Times Per Pass
+	for(passes = 0; socket_fired && passes < RELAY_PASS_LIMIT; passes++){
+		if((count = mux_fill(&set->input, client->client_fd)) == 0 || (count == -1 && errno != EAGAIN)){
+			terminate_client(client->client_fd, -1, MARK);
+			return -1;
+		}
+		while((parsed = mux_next(&set->input, &frame)) == 1){
+			if(mux_frame(client, &frame) == -1){
+				parsed = -1;
+				break;
 			}
-			
-		//True Error Writing Case
-		}else{								
-			perror("\nIn Function (transfer_data), Error Writing... NOTE: This Error"
-				   " Exits The Corresponding Function");
-			
-			if(rearm_epoll(source_fd, REARM_OUT) == -1){
-				perror("\nIn Function (unwritten_data), Error Rearming Source File Descriptor For Epoll"
-					  "Unit. NOTE: This Error Terminates The Client Connection.\n");
-				terminate_client(source_fd, fd_pairs[source_fd], MARK);
-				return;
+		}
+		if(parsed == -1){
+			perror("\nIn Function (mux_session), Malformed Frame Or Channel Credit Exceeded."
+				   " NOTE: This Error Closes The Client And Every Channel.\n");
+			terminate_client(client->client_fd, -1, MARK);
+			return -1;
+		}
+		if(count == -1){
+			break;
+		}
+	}
+	int yielded = (passes == RELAY_PASS_LIMIT);
+	
+	//Pump Every Channel With Work, Then Give Blocked Ones One More Turn Once The Socket Took Output
+	for(int round = 0; ; round++){
+		while((channel = channel_next(set)) != NULL){
+			if(pump_channel(client, channel, source_fd) == -1){
+				return -1;
 			}
-			
-			terminate_client(source_fd, fd_pairs[source_fd], MARK);
-			return;
 		}
-	//Default Successful Write Case
+		if(mux_flush(&set->output, client->client_fd) == -1){
+			terminate_client(client->client_fd, -1, MARK);
+			return -1;
+		}
+		if(set->blocked == NULL || round == 1){
+			break;
+		}
+		channel_unblock(set);
+	}
+	
+	yielded |= channel_requeue(set);
+	metrics_add(METRIC_BYTES_TO_PTY, set->moved_to_pty);
+	metrics_add(METRIC_BYTES_TO_SOCKET, set->moved_to_socket);
+	set->moved_to_pty = set->moved_to_socket = 0;
+	
+	//Frames The Socket Refused Stall The Whole Connection, Credit Only Stalls A Channel
+	client->last_activity = wheel_now(&client->reactor->wheel);
+	if(mux_pending(&set->output) > 0){
+		note_stall(client);
 	}else{
-		if(rearm_epoll(source_fd, REARM_IN) == -1){
-				perror("\nIn Function (transfer_data), Error Rearming Source File Descriptor For"
-					   " Epoll Unit. NOTE: This Error Terminates The Client Connection.\n");
-				terminate_client(source_fd, fd_pairs[source_fd], MARK);
-				return;
+		set_client_state(client, ESTABLISHED);
+		yielded |= (set->blocked != NULL);
+	}
+	if(edge_triggered){
+		if(passes == RELAY_PASS_LIMIT){
+			atomic_store(&session_lookup(client->client_fd)->fired, 1);	//Unread Frames Remain
+		}
+		if(yielded){
+			atomic_store(&client->rerun, 1);
+		}
+		return 0;
+	}
+	
+	//Socket Interest Follows Pending Frames, And Blocked Channels Wait On The Same Drain
+	client_events = REARM_IN | (mux_pending(&set->output) > 0 || set->blocked != NULL ? REARM_OUT : 0);
+	if(source_fd == client->client_fd || yielded || client_events != client->client_events){
+		if(rearm_epoll(client->reactor->epoll_fd, client->client_fd, client_events) == -1){
+			perror("\nIn Function (mux_session), Error Rearming Client File Descriptor For"
+				   " Epoll Unit. NOTE: This Error Terminates The Client Connection.\n");
+			terminate_client(client->client_fd, -1, MARK);
+			return -1;
 		}
+		client->client_events = client_events;
 	}
+	return 0;
 }
 
 
-void unwritten_data(int source_fd){
-	int chars_read = client_pairs[source_fd]->unwritten_num, chars_written = 0;
+void mark_fired(Client *client, int source_fd){
+	Session_Entry *entry = session_lookup(source_fd);
 	
-	//Write to File Descriptor
-	if((chars_written = write(fd_pairs[source_fd],  client_pairs[source_fd]->unwritten,
-							  chars_read)) < chars_read){
-		
-		//Partial Write Error	
-		if(errno != EAGAIN){
-			perror("\nIn Function (unwritten_data), Error Writing... NOTE: This Error"
-				   " Exits The Corresponding Function");
+	//Marks Outlive The Event, Whichever Thread Next Holds The Lock Takes Them
+	if(entry != NULL){
+		atomic_store(&entry->fired, 1);
+		if(source_fd != client->client_fd){
+			atomic_store(&client->masters_fired, 1);
+		}
+	}
+}
+
+
+void collect_fired(Client *client){
+	Channel_Set *set = client->channels;
+	Channel *channel;
+	
+	//Only Open Channels Are Looked At, Marks Left On Closed Masters Are Reset When Remapped
+	for(int id = 0; id < MUX_MAX_CHANNELS; id++){
+		if((channel = set->channels[id]) != NULL &&
+		   atomic_exchange(&session_lookup(channel->master_fd)->fired, 0)){
+			channel_ready(set, channel);
+		}
+	}
+}
+
+
+int mux_frame(Client *client, const Mux_Frame *frame){
+	Channel_Set *set = client->channels;
+	Channel *channel = set->channels[frame->channel];
+	
+	//Frames Racing A Close Are Dropped, Reopening A Live Channel Is An Error
+	switch(frame->type){
+		case MUX_OPEN:
+			return channel == NULL ? open_channel(client, frame->channel, frame->value) : -1;
 			
-			terminate_client(source_fd, fd_pairs[source_fd], MARK);
-			return;
-		
-		//Partial Write Again Case
-		}else{								
+		case MUX_DATA:
+			return channel == NULL ? 0 : channel_deliver(set, channel, frame->payload, frame->value);
+			
+		case MUX_CREDIT:
+			if(channel != NULL){
+				channel_grant(set, channel, frame->value);
+			}
+			return 0;
+			
+		case MUX_CLOSE:
+			return channel == NULL ? 0 : close_channel(client, channel, 1);
+	}
+	return -1;
+}
+
+
+int pump_channel(Client *client, Channel *channel, int source_fd){
+	uint32_t events;
+	
+	switch(channel_pump(client->channels, channel)){
+		case CHANNEL_CLOSED:	//The Shell Exited, The Client Hears CLOSE
+			if(close_channel(client, channel, 1) == -1){
+				terminate_client(client->client_fd, -1, MARK);
+				return -1;
+			}
+			return 0;
+			
+		case CHANNEL_BLOCKED:
+			channel_block(client->channels, channel);
+			break;
 			
-			//perror("Partial Write AGain...........");
-			client_pairs[source_fd]->unwritten = (client_pairs[source_fd]->unwritten + chars_written);
-			client_pairs[source_fd]->unwritten_num = chars_read - chars_written;			
-			client_pairs[source_fd]->state = UNWRITTEN;
+		case CHANNEL_YIELD:	//Used Its Reads, Goes Again Behind The Others Next Pass
+			channel_defer(client->channels, channel);
+			break;
 			
-			if(rearm_epoll(source_fd, REARM_OUT) == -1){
-				perror("\nIn Function (unwritten_data), Error Rearming Source File Descriptor For Epoll"
-					  "Unit. NOTE: This Error Terminates The Client Connection.\n");
-				terminate_client(source_fd, fd_pairs[source_fd], MARK);
-				return;
+		case CHANNEL_IDLE:
+			break;
+	}
+	if(edge_triggered){
+		return 0;
+	}
+	
+	//A Master That Fired Must Be Rearmed Even If Its Interest Is Unchanged
+	events = channel_events(channel);
+	if(channel->master_fd == source_fd || events != channel->events){
+		if(rearm_epoll(client->reactor->epoll_fd, channel->master_fd, events) == -1){
+			perror("\nIn Function (pump_channel), Error Rearming Master File Descriptor For"
+				   " Epoll Unit. NOTE: This Error Closes The Channel.\n");
+			if(close_channel(client, channel, 1) == -1){
+				terminate_client(client->client_fd, -1, MARK);
+				return -1;
 			}
+			return 0;
 		}
+		channel->events = events;
+	}
+	return 0;
+}
+
+
+int open_channel(Client *client, uint16_t id, uint32_t credit){
+	Channel_Set *set = client->channels;
+	Channel *channel;
+	char slave_name[MAX_BUFF];
+	int master_fd, warm;
+	
+	//A Shell That Cannot Start Is Refused With CLOSE, The Other Channels Carry On
+	if((master_fd = open_shell(slave_name, &warm)) == -1){
+		perror("\nIn Function (open_channel), Failure To Create The PTY Master And"
+			   " Slave Pairs. NOTE: This Error Refuses The Channel.");
+		return mux_send(&set->output, MUX_CLOSE, id, 0, NULL);
+	}
+	if((channel = channel_open(set, id, master_fd, credit)) == NULL){
+		close(master_fd);
+		return mux_send(&set->output, MUX_CLOSE, id, 0, NULL);
+	}
+	metrics_add(METRIC_CHANNELS_OPENED, 1);
+	
+	//The Master Shares The Connection's Slot And Lock, Its Entry Names The Channel
+	if(session_map(master_fd, client->client_fd, session_lookup(client->client_fd)->slot,
+				   client->state, client->home) == -1){
+		perror("\nIn Function (open_channel), Failed To Map The Master File Descriptor"
+			   " In The Session Table. NOTE: This Error Refuses The Channel.");
+		return close_channel(client, channel, 1);
+	}
+	session_lookup(master_fd)->channel = id;
+	
+	//Edge Triggered Masters Are Watched For Both Directions From The Start
+	if(add_to_epoll(client->reactor->epoll_fd, master_fd, edge_triggered ? REARM_IN | REARM_OUT : REARM_IN) == -1){
+		perror("\nIn Function (open_channel), Failed To Add Master File Descriptor"
+			   " To Epoll Unit. NOTE: This Error Refuses The Channel.");
+		return close_channel(client, channel, 1);
+	}
+	channel->events = REARM_IN;
+	
+	//Pooled Shells Are Already Running On Their Slave
+	if(!warm && start_bash(client->client_fd, master_fd, slave_name) == -1){
+		return close_channel(client, channel, 1);
+	}
+	return mux_send(&set->output, MUX_OPEN, id, MUX_WINDOW, NULL);
+}
+
+
+int close_channel(Client *client, Channel *channel, int notify){
+	//Unmap Before Closing So A Recycled Descriptor Never Reaches This Connection
+	session_unmap(channel->master_fd);
+	metrics_add(METRIC_CHANNELS_CLOSED, 1);
+	return channel_close(client->channels, channel, notify);
+}
+
+
+void close_channels(Client *client){
+	Channel_Set *set = client->channels;
+	
+	//Shells Still Open Go Down With The Connection Without Notice
+	for(int id = 0; id < MUX_MAX_CHANNELS; id++){
+		if(set->channels[id] != NULL){
+			close_channel(client, set->channels[id], 0);
+		}
+	}
+	channel_set_destroy(set);
+	client->channels = NULL;
+}
+
+
+size_t coalesce_limit(Client *client){
+	uint64_t now;
+	int flushing = client->flushing;
+	
+	client->flushing = 0;
+	if(coalesce_ns == 0 || flushing){
+		return 0;
+	}
+	
+	//Echo And Prompt Redraws Follow Keystrokes And Go Out Immediately
+	now = metrics_now();
+	if(client->to_pty.moved > 0){
+		client->last_input = now;
+	}
+	if(now - client->last_input < INTERACTIVE_MS * 1000000ull){
+		return 0;
+	}
+	
+	//Output Held Past Its Deadline Is Flushed Whatever Its Size
+	if(client->held_since != 0 && now - client->held_since >= coalesce_ns){
+		return 0;
+	}
+	return COALESCE_BYTES;
+}
+
+
+void tune_compression(Client *client){
+	int backlog;
+	
+	//Bytes Still Queued In The Socket Show Whether The Link Or The CPU Is Behind
+	if(ioctl(client->client_fd, SIOCOUTQ, &backlog) == 0){
+		codec_tune(client->to_socket.codec, backlog);
+	}
+}
+
+
+void hold_output(Client *client){
+	Reactor *reactor = client->reactor;
+	
+	if(client->held_pprev != NULL){
+		return;
+	}
+	client->held_since = metrics_now();
+	
+	//The First Held Session Starts The Loop's Flush Deadline
+	pthread_mutex_lock(&reactor->flush_lock);
+	if(reactor->held == NULL && arm_flush(reactor) == -1){
+		perror("\nIn Function (hold_output), Error Arming The Output Flush Timer."
+			   " NOTE: Held Output Is Written On The Session's Next Event.");
+	}
+	client->held_next = reactor->held;
+	client->held_pprev = &reactor->held;
+	if(reactor->held != NULL){
+		reactor->held->held_pprev = &client->held_next;
+	}
+	reactor->held = client;
+	pthread_mutex_unlock(&reactor->flush_lock);
+}
+
+
+void release_output(Client *client){
+	Reactor *reactor = client->reactor;
+	
+	//Caller Holds The Client Lock, The List Itself Is Guarded By The Reactor
+	pthread_mutex_lock(&reactor->flush_lock);
+	if(client->held_pprev != NULL){
+		*client->held_pprev = client->held_next;
+		if(client->held_next != NULL){
+			client->held_next->held_pprev = client->held_pprev;
+		}
+		client->held_pprev = NULL;
+	}
+	pthread_mutex_unlock(&reactor->flush_lock);
+	client->held_since = 0;
+}
+
+
+void flush_held(Reactor *reactor){
+	Client *client, *next, *claimed = NULL, **link;
+	uint64_t expirations;
+	
+	//Clear The Expiration Count So The Timer Can Fire Again
+	read(reactor->flush_fd, &expirations, sizeof(expirations));
+	
+	//Take Every Held Session Not Busy Elsewhere, Busy Ones Wait For The Next Deadline
+	pthread_mutex_lock(&reactor->flush_lock);
+	for(link = &reactor->held; (client = *link) != NULL;){
+		if(pthread_mutex_trylock(&client->lock) != 0){
+			link = &client->held_next;
+			continue;
+		}
+		*link = client->held_next;
+		if(client->held_next != NULL){
+			client->held_next->held_pprev = link;
+		}
+		client->held_pprev = NULL;
+		client->held_since = 0;
+		client->held_next = claimed;
+		claimed = client;
+	}
+	if(reactor->held != NULL && arm_flush(reactor) == -1){
+		perror("\nIn Function (flush_held), Error Rearming The Output Flush Timer."
+			   " NOTE: Held Output Is Written On The Session's Next Event.");
+	}
+	pthread_mutex_unlock(&reactor->flush_lock);
+	
+	//A Forced Pass Writes The Held Bytes In One Go And Releases The Lock
+	for(client = claimed; client != NULL; client = next){
+		next = client->held_next;
+		client->flushing = 1;
+		int client_fd = client->client_fd;
+		resume_session(client, -1);
 		
-	//Successful Write Case
-	}else{
-		client_pairs[source_fd]->state = ESTABLISHED;
-		
-		if(rearm_epoll(source_fd, REARM_IN) == -1){
-				perror("\nIn Function (unwritten_data), Error Rearming Source File Descriptor For Epoll"
-					  "Unit. NOTE: This Error Terminates The Client Connection.\n");
-				terminate_client(source_fd, fd_pairs[source_fd], MARK);
-				return;
+		//Edge Triggered Events That Arrived While The Flush Held The Session Run Now
+		if(edge_triggered && atomic_load(&client->rerun)){
+			dispatch_event(reactor, client_fd);
 		}
 	}
+	
+	//Rearm Epoll For Input
+	if(!edge_triggered && rearm_epoll(reactor->epoll_fd, reactor->flush_fd, REARM_IN) == -1){
+		perror("\nIn Function (flush_held), Error Rearming Output Flush Timer For Epoll"
+			   " Loop. NOTE: Held Output Is Written On Each Session's Next Event.\n");
+	}
+}
+
+
+int arm_flush(Reactor *reactor){
+	struct itimerspec time_specs;
+	
+	//One Shot, Rearmed Only While Sessions Are Still Held
+	memset(&time_specs, 0, sizeof(time_specs));
+	time_specs.it_value.tv_sec = coalesce_ns / 1000000000ull;
+	time_specs.it_value.tv_nsec = coalesce_ns % 1000000000ull;
+	return timerfd_settime(reactor->flush_fd, 0, &time_specs, NULL);
 }
 
 
 void handle_bash(char *slave_name){
+	//Ignored Dispositions Survive Exec, So Give The Shell The Defaults Back
+	signal(SIGPIPE, SIG_DFL);
+	signal(SIGCHLD, SIG_DFL);
+	
 	//Create New Session ID
 	if(setsid() == -1){
 		perror("\nIn Function (handle_bash), Error Setting Session ID In Order To"
@@ -487,29 +1592,91 @@ void handle_bash(char *slave_name){
 
 
 void terminate_client(int client_fd, int master_fd, int mark_terminated){
+	Client *client;
+	
 	//Mark Client Object Terminated
 	if(mark_terminated){
-		client_pairs[client_fd]->state = TERMINATED;
+		client = session_client(client_fd);
+		set_client_state(client, TERMINATED);
+		metrics_add(METRIC_TERMINATED, 1);
 	}else{
 		close(client_fd);	//Failrue In Accept Clients Before Obj Allocation
 		return;
 	}
 	
+	//Pending Timeouts, Held Output And Multiplexed Shells Must Not Outlive The Client
+	wheel_cancel(&client->reactor->wheel, &client->timer);
+	if(client->channels != NULL){
+		close_channels(client);
+	}
+	if(client->held_pprev != NULL){
+		release_output(client);
+	}
+	
+	//Outstanding Completions Hold The Descriptors Open Until Cancelled
+	if(io_engine == ENGINE_URING){
+		uring_cancel_session(client);
+	}
+	
+	//Unmap Before Closing So Recycled Descriptors Never See This Object
+	session_unmap(client_fd);
+	if(master_fd != -1){
+		session_unmap(master_fd);
+	}
+	
 	//Close Corresponding File Descriptors
 	if(master_fd == -1){
 		close(client_fd);
-		free(client_pairs[client_fd]);
 	}else{
 		close(client_fd);
 		close(master_fd);
-		free(client_pairs[client_fd]);
 	}
+	
+	//Release Relay Buffers And The Lock Held By The Caller
+	relay_destroy(&client->to_pty);
+	relay_destroy(&client->to_socket);
+	pthread_mutex_unlock(&client->lock);
+	release_client_memory(client);
+}
+
+
+int spawn_bash(char *slave_name){
+	posix_spawnattr_t attributes;
+	posix_spawn_file_actions_t actions;
+	sigset_t defaults;
+	char *arguments[] = {"bash", NULL};
+	int result;
+	
+	//The Same Steps As handle_bash, Run By A vfork Style Child That Shares Our Memory
+	sigemptyset(&defaults);
+	sigaddset(&defaults, SIGPIPE);
+	sigaddset(&defaults, SIGCHLD);
+	posix_spawnattr_init(&attributes);
+	posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSID | POSIX_SPAWN_SETSIGDEF);
+	posix_spawnattr_setsigdefault(&attributes, &defaults);
+	
+	//Opening The Slave After setsid Makes It The Controlling Terminal
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, slave_name, O_RDWR, 0);
+	posix_spawn_file_actions_adddup2(&actions, STDIN_FILENO, STDOUT_FILENO);
+	posix_spawn_file_actions_adddup2(&actions, STDIN_FILENO, STDERR_FILENO);
+	
+	//Every Other Server Descriptor Is Close On Exec
+	result = posix_spawnp(&bash_pid, "bash", &actions, &attributes, arguments, environ);
+	posix_spawn_file_actions_destroy(&actions);
+	posix_spawnattr_destroy(&attributes);
+	if(result != 0){
+		errno = result;
+		perror("\nIn Function (spawn_bash), Error Spawning Bash Process For Client"
+			   " Interaction. NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	return 0;
 }
 
 
-int create_socket(){
-	//Listening Socket Constant
-	const int MAX_BACKLOG = 5;
+int create_socket(Reactor *reactor){
+	int server_fd;
 	
 	//Address Initialization
 	struct sockaddr_in server_address;
@@ -524,6 +1691,24 @@ int create_socket(){
 				  " Corresponding Function.");
 		return -1;
 	}
+	reactor->server_fd = server_fd;
+	
+	//Set Addresss Reuse in Termination
+	int i=1;
+	if(setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &i, sizeof(i)) == -1){
+		perror("\nIn Function (create_socket), Failed To Set The Address Of The"
+			   " Socket To Be Reused In The Event Of Termination To Enhance Testing."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	
+	//Let Every Event Loop Bind Its Own Listener So The Kernel Spreads Connections
+	if(setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &i, sizeof(i)) == -1){
+		perror("\nIn Function (create_socket), Failed To Set The Port Of The"
+			   " Socket To Be Shared Between Event Loops. NOTE: This Error Exits"
+			   " The Corresponding Function.");
+		return -1;
+	}
 		
 	//Bind Address with Socket
     if(bind(server_fd, (struct sockaddr *) &server_address, sizeof(server_address)) == -1){
@@ -533,45 +1718,52 @@ int create_socket(){
 		return -1;
 	}
 	
-	//Listen for Connections on Socket
-    if(listen(server_fd, MAX_BACKLOG) == -1){
-		perror("\nIn Function (create_socket), Failed To Set The Listening Socket As A"
-			   " Passive Socket To Accept Incoming Client Connections. NOTE: This"
-			   " Error Exits The Corresponding Function.");
+	//Clients That Send First Can Be Accepted Only Once Their Data Is Queued
+	if(defer_accept > 0 && setsockopt(server_fd, IPPROTO_TCP, TCP_DEFER_ACCEPT,
+									  &defer_accept, sizeof(defer_accept)) == -1){
+		perror("\nIn Function (create_socket), Failed To Defer Accepting Until Client"
+			   " Data Arrives. NOTE: This Error Exits The Corresponding Function.");
 		return -1;
 	}
 	
-	//Set Addresss Reuse in Termination
-	int i=1;
-	if(setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &i, sizeof(i)) == -1){
-		perror("\nIn Function (create_socket), Failed To Set The Address Of The"
-			   " Socket To Be Reused In The Event Of Termination To Enhance Testing."
-			   " NOTE: This Error Exits The Corresponding Function.");
+	//Each Event Loop's Listener Is Preferred For Connections Received On Its CPU
+	if(reactor_count > 0 && reactor->cpu != -1 && setsockopt(server_fd, SOL_SOCKET, SO_INCOMING_CPU,
+															 &reactor->cpu, sizeof(reactor->cpu)) == -1){
+		perror("\nIn Function (create_socket), Failed To Steer Connections To The Event"
+			   " Loop's CPU. NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	
+	//Listen for Connections on Socket, Deep Enough To Absorb A Reconnect Storm
+    if(listen(server_fd, listen_backlog) == -1){
+		perror("\nIn Function (create_socket), Failed To Set The Listening Socket As A"
+			   " Passive Socket To Accept Incoming Client Connections. NOTE: This"
+			   " Error Exits The Corresponding Function.");
 		return -1;
 	}
 	return 0;
 }
 
 
-int create_pty_pair(int client_fd, char *slave_name){
+int create_pty_pair(char *slave_name){
 	//Variable to Hold Slave and Master fd and name
 	char *slave_temp;
 	int master_fd;
 	
 	//Opent PTY Master File Descriptor
-	if((master_fd = posix_openpt(O_RDWR | O_NOCTTY)) == -1){
+	if((master_fd = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC)) == -1){
 		perror("\nIn Function (create_pty_pair), Error Opening Master File Descriptor"
 			   " For The PTY. NOTE: This Error Exits The Corresponding Function.");
-		terminate_client(client_fd, -1, MARK);
 		return -1;
 	}
 	
-	//Set Up Close on Exec for Master File Descriptor
-	if(fcntl(master_fd, F_SETFD, FD_CLOEXEC | O_NONBLOCK) == -1){
+	//Set Up Close on Exec And Nonblocking Relaying for Master File Descriptor
+	if(fcntl(master_fd, F_SETFD, FD_CLOEXEC) == -1 ||
+	   fcntl(master_fd, F_SETFL, fcntl(master_fd, F_GETFL) | O_NONBLOCK) == -1){
 		perror("\nIn Function (create_pty_pair), Error Setting Up Close On Exec For"
 			   " The PTY Master File Descriptor. NOTE: This Error Exits The"
 			   " Corresponding Function.");
-		terminate_client(client_fd, master_fd, MARK);
+		close(master_fd);
 		return -1;
 	}
 	
@@ -580,7 +1772,7 @@ int create_pty_pair(int client_fd, char *slave_name){
 		perror("\nIn Function (create_pty_pair), Error Unlocking The PTY Master File"
 			   " Descriptor In Order To Get The PTY Slave Pairing For The PTY."
 			   " NOTE: This Error Exits The Corresponding Function.");
-		terminate_client(client_fd, master_fd, MARK);
+		close(master_fd);
 		return -1;
 	}
 	
@@ -589,7 +1781,7 @@ int create_pty_pair(int client_fd, char *slave_name){
 	if(slave_temp == NULL){
 		perror("\nIn Function (create_pty_pair), Error Opening The PTY Slave Name And"
 			   " Storing. NOTE: This Error Exits The Corresponding Function.");
-		terminate_client(client_fd, master_fd, MARK);
+		close(master_fd);
 		return -1;
 	}
 	
@@ -598,7 +1790,7 @@ int create_pty_pair(int client_fd, char *slave_name){
 		perror("\nIn Function (create_pty_pair), Error Storing The Slave Name In A"
 			   " Temporary Variable To Avoid Writting Over It With Another Function"
 			   " Call. NOTE: This Error Exits The Corresponding Function.");
-		terminate_client(client_fd, master_fd, MARK);
+		close(master_fd);
 		return -1;
 	}
 	
@@ -610,32 +1802,98 @@ int create_pty_pair(int client_fd, char *slave_name){
 
 
 int init_client(int client_fd){
-	int master_fd;
+	int master_fd, warm;
 	char slave_name[MAX_BUFF];
 	
-	//Open PTY and get Master and Slaves
-	if((master_fd = create_pty_pair(client_fd, slave_name)) == -1){
-			perror("\nIn Function (init_client), Failure To Create The PTY Master And"
-				   " Slave Pairs. NOTE: This Error Exits The Corresponding Thread"
-				   " Resulting In The Client Terminating.");
-		return -1; //Client Termination Occurs In Function create_pty_pair
+	//Open PTY and get Master and Slaves, Or A Warm Shell Already Running On One
+	if((master_fd = open_shell(slave_name, &warm)) == -1){
+		perror("\nIn Function (init_client), Failure To Create The PTY Master And"
+			   " Slave Pairs. NOTE: This Error Exits The Corresponding Thread"
+			   " Resulting In The Client Terminating.");
+		terminate_client(client_fd, -1, MARK);
+		return -1;
 	}
 	
 	//Add Client Object Mapping With PTY Master
-	client_pairs[master_fd] = client_pairs[client_fd];
+	Client *client = session_client(client_fd);
+	client->master_fd = master_fd;
 	
 	//Store Client File Descriptor and Master File Descriptor Pairs
-	fd_pairs[client_fd] = master_fd;
-	fd_pairs[master_fd] = client_fd;
-	
-	//Add Master File Descriptor to Epoll Unit
-	if(add_to_epoll(master_fd) == -1){
-		perror("\nIn Function (init_client), Failed To Add Master File Descriptor" 
-			   " To Epoll Unit. NOTE: This Error Exits The Corresponding Thread"
+	uint32_t slot = session_lookup(client_fd)->slot;
+	if(session_map(master_fd, client_fd, slot, client->state, client->home) == -1 ||
+	   session_map(client_fd, master_fd, slot, client->state, client->home) == -1){
+		perror("\nIn Function (init_client), Failed To Map The Master File Descriptor"
+			   " In The Session Table. NOTE: This Error Exits The Corresponding Thread"
 			   " Resulting In The Client Terminating.");
+		session_unmap(master_fd);
+		close(master_fd);
+		terminate_client(client_fd, -1, MARK);
+		return -1;
+	}
+	
+	//The io_uring Engine Relays Through Provided Buffers Instead Of These
+	if(io_engine == ENGINE_EPOLL){
+		//Allocate Each Direction's Relay Buffer Once The Client Is Verified
+		//Compressed Sessions Are Transformed In User Space So They Always Copy
+		Relay_Mode mode = client->compressed ? RELAY_COPY : relay_mode;
+		//Placed Sessions Bind Their Rings To Their Slot's Node, Whichever Worker Runs The Setup
+		int node = client_node(client);
+		if(relay_init(&client->to_pty, client_fd, master_fd, mode, relay_capacity, node) == -1 ||
+		   relay_init(&client->to_socket, master_fd, client_fd, mode, relay_capacity, node) == -1 ||
+		   (client->compressed && (relay_compress(&client->to_pty, CODEC_DECOMPRESS) == -1 ||
+								   relay_compress(&client->to_socket, CODEC_COMPRESS) == -1))){
+			perror("\nIn Function (init_client), Failed To Allocate Relay Buffers For The"
+				   " Client. NOTE: This Error Exits The Corresponding Thread"
+				   " Resulting In The Client Terminating.");
+			terminate_client(client_fd, master_fd, MARK);
+			return -1;
+		}
+	
+		//Add Master File Descriptor to Epoll Unit
+		//Edge Triggered Masters Are Watched For Both Directions From The Start
+		if(add_to_epoll(client->reactor->epoll_fd, master_fd, edge_triggered ? REARM_IN | REARM_OUT : REARM_IN) == -1){
+			perror("\nIn Function (init_client), Failed To Add Master File Descriptor" 
+				   " To Epoll Unit. NOTE: This Error Exits The Corresponding Thread"
+				   " Resulting In The Client Terminating.");
+			terminate_client(client_fd, master_fd, MARK);
+			return -1;
+		}
+		client->master_events = REARM_IN;
+	}
+	
+	//Pooled Shells Are Already Running On Their Slave
+	if(!warm && start_bash(client_fd, master_fd, slave_name) == -1){
 		terminate_client(client_fd, master_fd, MARK);
 		return -1;
 	}
+	return 0;
+}
+
+
+int open_shell(char *slave_name, int *warm){
+	int master_fd;
+	
+	//Claim A Warm Shell, Opening A PTY Here Only When The Pool Is Empty Or Disabled
+	if((master_fd = shell_pool_claim()) != -1){
+		*warm = 1;
+		return master_fd;
+	}
+	*warm = 0;
+	return create_pty_pair(slave_name);
+}
+
+
+int start_bash(int client_fd, int master_fd, char *slave_name){
+	//Spawning Costs The Same However Large The Server's Address Space Grows
+	if(launch_mode == LAUNCH_SPAWN){
+		if(spawn_bash(slave_name) == -1){
+			perror("\nIn Function (start_bash), This Error Results From The Failure"
+				   " Of posix_spawn Starting The Client's Bash Session. NOTE: This Error"
+				   " Exits The Corresponding Thread Resulting In The Client Terminating.");
+			return -1;
+		}
+		return 0;
+	}
 	
 	//Handle Bash in Subprocess
 	switch((bash_pid = fork())){
@@ -646,74 +1904,188 @@ int init_client(int client_fd){
 			handle_bash(slave_name);
 		break;
 		case -1:
-			perror("\nIn Function (init_client), This Error Results From The Failure"
+			perror("\nIn Function (start_bash), This Error Results From The Failure"
 				   " Of The Fork Call Making A New Process To Run The Client's Bash"
 				   " Session. NOTE: This Error Exits The Corresponding Thread"
 				   " Resulting In The Client Terminating.");
-			terminate_client(client_fd, master_fd, MARK);
 			return -1;
 	}
 	return 0;
 }
 
 
-int init_client_obj(int client_fd){
-	//Create Client Object
-	if((client_pairs[client_fd] = malloc(sizeof(Client))) == NULL){
-		perror("\nIn Function (init_client_obj), Error Allocating Memory To Hold"
-			   " Client Structure. NOTE An Error Occurred Causing The Infinite Server"
-			   " Loop To Terminate Causing The Server To Crash.\n");
+int init_client_obj(int client_fd, int node, uint16_t home){
+	Client *client;
+	
+	//Take A Client Object From The Preallocated Slab
+	if((client = allocate_client_memory(node)) == NULL){
+		perror("\nIn Function (init_client_obj), No Free Client Slot Is Left To Hold"
+			   " Client Structure. NOTE: This Error Ends The Client Connection.\n");
 		return -1;
 	}
 
+	//Reset The Recycled Slot Under Its Own Lock
+	pthread_mutex_lock(&client->lock);
+	client->generation++;
+	atomic_store(&client->rerun, 0);
+	atomic_store(&client->masters_fired, 0);
+	memset((char *) client + offsetof(Client, reactor), 0, sizeof(Client) - offsetof(Client, reactor));
+	
 	//Set Client State
-	client_pairs[client_fd]->state = NEW;
-	client_pairs[client_fd]->client_fd = client_fd;
+	client->state = NEW;
+	client->home = home;
+	client->client_fd = client_fd;
+	client->master_fd = -1;
+	client->client_events = REARM_IN;
+	client->to_pty.pipe_fds[0] = client->to_pty.pipe_fds[1] = -1;
+	client->to_socket.pipe_fds[0] = client->to_socket.pipe_fds[1] = -1;
+	
+	//Map The Socket To Its Slot, Paired With Itself Until A PTY Exists
+	if(session_map(client_fd, client_fd, client - client_slab + 1, NEW, home) == -1){
+		pthread_mutex_unlock(&client->lock);
+		release_client_memory(client);
+		return -1;
+	}
+	atomic_fetch_add_explicit(&pending_handshakes, 1, memory_order_relaxed);
+	return 0;
+}
+
+
+int init_client_memory(size_t capacity){
+	//Slab Of Cache Line Aligned Client Slots
+	if((client_slab = aligned_alloc(CACHE_LINE, sizeof(Client) * capacity)) == NULL ||
+	   (memory_nodes = malloc(sizeof(Linked_Memory) * capacity)) == NULL){
+		perror("\nIn Function (init_client_memory), Error Allocating The Client Slab."
+			   " NOTE: This Error Exits The Corresponding Function.\n");
+		return -1;
+	}
+	
+	//Placement Splits The Slab Into One Run Per Node, Bound Before Any Slot Is Touched
+	slab_partitions = placement ? topology_nodes() : 1;
+	partition_slots = (capacity + slab_partitions - 1) / slab_partitions;
+	for(int node = 0; node < slab_partitions; node++){
+		size_t first = node * partition_slots;
+		size_t last = first + partition_slots < capacity ? first + partition_slots : capacity;
+		if(placement && first < last &&
+		   (topology_bind(&client_slab[first], sizeof(Client) * (last - first), node) == -1 ||
+			topology_bind(&memory_nodes[first], sizeof(Linked_Memory) * (last - first), node) == -1)){
+			perror("\nIn Function (init_client_memory), Error Placing The Client Slab"
+				   " On Its Nodes. NOTE: This Error Exits The Corresponding Function.\n");
+			return -1;
+		}
+		pthread_mutex_init(&free_memory_mtx[node], NULL);
+		free_memory[node] = NULL;
+	}
+	
+	//Thread Every Slot Onto Its Partition's Free List, Lowest Address First
+	for(size_t index = capacity; index-- > 0;){
+		int node = index / partition_slots;
+		pthread_mutex_init(&client_slab[index].lock, NULL);
+		memory_nodes[index].data = &client_slab[index];
+		memory_nodes[index].next = free_memory[node];
+		free_memory[node] = &memory_nodes[index];
+	}
 	return 0;
 }
 
 
-int send_protocol(int client_fd){
+Client *allocate_client_memory(int node){
+	Linked_Memory *node_memory = NULL;
+	
+	//Prefer The Requested Node, Spilling To The Others Only When It Is Exhausted
+	for(int offset = 0; offset < slab_partitions && node_memory == NULL; offset++){
+		int partition = (node + offset) % slab_partitions;
+		pthread_mutex_lock(&free_memory_mtx[partition]);
+		if((node_memory = free_memory[partition]) != NULL){
+			free_memory[partition] = node_memory->next;
+		}
+		pthread_mutex_unlock(&free_memory_mtx[partition]);
+	}
+	
+	return node_memory == NULL ? NULL : node_memory->data;
+}
+
+
+int client_node(Client *client){
+	//A Slot's Partition Is The Node Its Memory Was Bound To, Unplaced Slabs Have One
+	return placement ? (int) ((client - client_slab) / partition_slots) : -1;
+}
+
+
+Client *session_client(int fd){
+	Session_Entry *entry = session_lookup(fd);
+	
+	if(entry == NULL || entry->slot == SESSION_UNMAPPED){
+		return NULL;
+	}
+	return &client_slab[entry->slot - 1];
+}
+
+
+void set_client_state(Client *client, Status state){
+	Session_Entry *entry;
+	
+	//Mirror Transitions Into The Session Table Only When They Change
+	if(client->state == state){
+		return;
+	}
+	
+	//Leaving NEW, Verified Or Not, Frees A Handshake Admission
+	if(client->state == NEW){
+		atomic_fetch_sub_explicit(&pending_handshakes, 1, memory_order_relaxed);
+	}
+	client->state = state;
+	if((entry = session_lookup(client->client_fd)) != NULL){
+		entry->state = state;
+	}
+	if(client->master_fd != -1 && (entry = session_lookup(client->master_fd)) != NULL){
+		entry->state = state;
+	}
+}
+
+
+void release_client_memory(Client *client){
+	//Each Slot Owns The List Node At The Same Index And Returns To Its Own Partition
+	Linked_Memory *node = &memory_nodes[client - client_slab];
+	int partition = (client - client_slab) / partition_slots;
+	
+	pthread_mutex_lock(&free_memory_mtx[partition]);
+	node->next = free_memory[partition];
+	free_memory[partition] = node;
+	pthread_mutex_unlock(&free_memory_mtx[partition]);
+}
+
+
+int send_protocol(Reactor *reactor, int client_fd){
 	const char * const rembash_message = "<rembash>\n";
 	
 	//Rembash Send
-	if(write(client_fd, rembash_message, strlen(rembash_message)) < strlen(rembash_message)){
+	size_t length = strlen(rembash_message);
+	ssize_t written = write(client_fd, rembash_message, length);
+	if(written == -1 || (size_t) written < length){
 		perror("\nIn Function (send_protocol), Error Sending Rembash Protocol Message"
 			   " To Client. NOTE This Error Causes The Client To Terminate.\n");
         return -1;
 	}
 	
-	//Create Timer to Prevent DOS Attacks
-	int timer_fd;
-	if((timer_fd = create_timer()) == -1){
-		perror("In Function (verify_protocol), Error Creating POSIX Timer.\n\tNOTE:"
+	//Arm Handshake Timeout to Prevent DOS Attacks
+	Client *client = session_client(client_fd);
+	client->timer.kind = TIMER_HANDSHAKE;
+	client->accepted_at = metrics_now();
+	if(wheel_schedule(&reactor->wheel, &client->timer, wheel_ticks(MAX_TIMER_AMOUNT)) == -1){
+		perror("In Function (send_protocol), Error Scheduling Handshake Timeout.\n\tNOTE:"
 			   " This Error Exits The Corresponding Function");
         return -1;
 	}
 	
-	//Add Timer File Descriptor To Epoll Timer
-	struct epoll_event ev;
-	ev.events = EPOLLIN | EPOLLONESHOT;
-	
-  	ev.data.fd = timer_fd;
-  	if(epoll_ctl(timer_epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev) == -1){
-    	perror("\nIn Function (send_protocol), Error Adding Timer File Descriptor To"
-			   " Timer Epoll Unit. NOTE: This Error Exits The Corresponding Function");
-		return -1;
-	}
-	
-	//Map Client And Timer FDs
-	clock_pairs[client_fd] = timer_fd;
-	clock_pairs[timer_fd] = client_fd;
-	
 	return 0;
 }
 
 
-int add_to_epoll(int source_fd){
+int add_to_epoll(int epoll_fd, int source_fd, uint32_t events){
 	//Add Client Socket and Master PTY File Descriptors to Epoll
 	struct epoll_event ev;
-	ev.events = EPOLLIN | EPOLLONESHOT;
+	ev.events = events | (edge_triggered ? EPOLLET : EPOLLONESHOT);
 	
   	ev.data.fd = source_fd;
   	if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, source_fd, &ev) == -1){
@@ -725,18 +2097,12 @@ int add_to_epoll(int source_fd){
 }
 
 
-int rearm_epoll(int source_fd, int in_or_out){
+int rearm_epoll(int epoll_fd, int source_fd, uint32_t events){
 	struct epoll_event ev;
 	ev.data.fd = source_fd;
 	
-	//Choose EPOLLIN or EPOLLOUT
-	switch(in_or_out){
-		case REARM_IN:
-			ev.events = EPOLLIN | EPOLLONESHOT;
-			break;
-		case REARM_OUT:
-			ev.events = EPOLLOUT | EPOLLONESHOT;
-	}
+	//Combine EPOLLIN And EPOLLOUT Interest
+	ev.events = events | (edge_triggered ? EPOLLET : EPOLLONESHOT);
 
 	//Reset File Descriptor To Properly Use Epoll's ONESHOT OPTION
 	if(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, source_fd, &ev) == -1){
@@ -749,32 +2115,280 @@ int rearm_epoll(int source_fd, int in_or_out){
 }
 
 
-int create_timer(){
-	struct itimerspec time_specs;
-	int timer_fd;
+void *run_uring(void *arg){
+	Reactor *reactor = arg;
+	struct io_uring_cqe *cqe, done;
 	
-	//Create Timer for DOS Attacks
-	if((timer_fd = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC)) == -1){
-		perror("In Function (create_timer), Failed To Create FD Timer In Order To"
-			   " Prevent DOS Attacks. Expiration Of This Timer Results In The"
-			   " Disconnection Of The Corresponding Client. \n\tNOTE: This Error Exits"
-			   " The Corresponding Function.");
+	//Listener And Timer Wheel Are Armed Once, Sessions Arm Themselves As They Go
+	if(uring_arm_accept(reactor) == -1 || uring_watch(reactor, reactor->wheel.timer_fd, REARM_IN) == -1){
+		perror("\nIn Function (run_uring), Failed To Arm The Listener And Timer Wheel."
+			   " NOTE: This Error Results In The Server Terminating.\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	//Everything Queued While Handling One Batch Goes Out With The Next Wait
+	while(uring_submit(&reactor->uring, 1) != -1){
+		while((cqe = uring_peek(&reactor->uring)) != NULL){
+			done = *cqe;
+			uring_seen(&reactor->uring);
+			complete_uring(reactor, &done);
+		}
+	}
+	perror("\nIn Function (run_uring - Completion Loop). NOTE An Error Occurred"
+		   " Causing The Event Loop To Terminate Causing The Server To"
+		   " Crash.\n");
+	exit(EXIT_FAILURE);
+}
+
+
+void complete_uring(Reactor *reactor, struct io_uring_cqe *cqe){
+	uint32_t slot = DATA_SLOT(cqe->user_data);
+	int flow = DATA_FLOW(cqe->user_data);
+	Client *client = slot == SESSION_UNMAPPED ? NULL : &client_slab[slot - 1];
+	
+	//Completions Outliving Their Session Only Give Back The Buffer They Hold
+	int stale = client != NULL && (client->generation != DATA_GEN(cqe->user_data) ||
+								   client->state == TERMINATED);
+	
+	switch(DATA_OP(cqe->user_data)){
+		case OP_ACCEPT:
+			if(cqe->res >= 0){
+				admit_client(reactor, cqe->res);
+			}
+			
+			//The Kernel Drops Multishot Accept After An Error So Arm It Again
+			if(!(cqe->flags & IORING_CQE_F_MORE) && uring_arm_accept(reactor) == -1){
+				perror("\nIn Function (complete_uring), Error Rearming Multishot Accept."
+					   " NOTE: This Stops New Connections On This Event Loop.\n");
+			}
+			break;
+			
+		case OP_POLL:	//Timer Wheel Or A Client Still In The Handshake
+			if(client == NULL){
+				handle_timers(reactor);
+			}else if(!stale && cqe->res >= 0){
+				dispatch_event(reactor, client->client_fd);
+			}
+			break;
+			
+		case OP_READ:
+			if(stale){
+				if(cqe->flags & IORING_CQE_F_BUFFER){
+					uring_recycle(&reactor->uring, cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+				}
+				break;
+			}
+			pthread_mutex_lock(&client->lock);
+			metrics_add(client->state == UNWRITTEN ? METRIC_EVENTS_UNWRITTEN : METRIC_EVENTS_ESTABLISHED, 1);
+			uring_read_done(client, flow, cqe);
+			break;
+			
+		case OP_WRITE:
+			if(stale){
+				uring_recycle(&reactor->uring, DATA_BID(cqe->user_data));
+				uring_feed_starved(reactor);
+				break;
+			}
+			pthread_mutex_lock(&client->lock);
+			metrics_add(client->state == UNWRITTEN ? METRIC_EVENTS_UNWRITTEN : METRIC_EVENTS_ESTABLISHED, 1);
+			uring_write_done(client, flow, DATA_BID(cqe->user_data), cqe->res);
+			break;
+	}
+}
+
+
+void uring_read_done(Client *client, int flow, struct io_uring_cqe *cqe){
+	//A Short Write Broke The Link And Its Completion Already Resubmitted
+	if(cqe->res == -ECANCELED){
+		pthread_mutex_unlock(&client->lock);
+		return;
+	}
+	
+	//Every Provided Buffer Is Held By A Write, Retry Once One Comes Back
+	if(cqe->res == -ENOBUFS){
+		uring_starve(client, flow);
+		pthread_mutex_unlock(&client->lock);
+		return;
+	}
+	
+	//End Of File Or A Read Error On Either Side Ends The Session
+	if(cqe->res <= 0){
+		if(cqe->flags & IORING_CQE_F_BUFFER){
+			uring_recycle(&client->reactor->uring, cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+		}
+		terminate_client(client->client_fd, client->master_fd, MARK);
+		return;
+	}
+	
+	//Write What Was Read, The Next Read Only Runs Once The Write Completes
+	client->last_activity = wheel_now(&client->reactor->wheel);
+	client->flow_length[flow] = cqe->res;
+	client->flow_sent[flow] = 0;
+	if(uring_write_flow(client, flow, cqe->flags >> IORING_CQE_BUFFER_SHIFT) == -1){
+		terminate_client(client->client_fd, client->master_fd, MARK);
+		return;
+	}
+	pthread_mutex_unlock(&client->lock);
+}
+
+
+void uring_write_done(Client *client, int flow, unsigned bid, int result){
+	Uring *ring = &client->reactor->uring;
+	
+	//A Destination That Refuses Bytes Ends The Session Like A Failed Write
+	if(result < 0){
+		uring_recycle(ring, bid);
+		terminate_client(client->client_fd, client->master_fd, MARK);
+		return;
+	}
+	client->flow_sent[flow] += result;
+	metrics_add(flow == FLOW_TO_PTY ? METRIC_BYTES_TO_PTY : METRIC_BYTES_TO_SOCKET, result);
+	
+	//The Destination Pushed Back, Write The Rest And Read Again After It
+	if(client->flow_sent[flow] < client->flow_length[flow]){
+		metrics_add(METRIC_PARTIAL_WRITES, 1);
+		note_stall(client);
+		if(uring_write_flow(client, flow, bid) == -1){
+			uring_recycle(ring, bid);
+			terminate_client(client->client_fd, client->master_fd, MARK);
+			return;
+		}
+		pthread_mutex_unlock(&client->lock);
+		return;
+	}
+	
+	//Buffer Drained, Its Linked Read Is Already Running
+	client->flow_length[flow] = 0;
+	if(client->flow_length[!flow] == 0){
+		set_client_state(client, ESTABLISHED);
+	}
+	uring_recycle(ring, bid);
+	pthread_mutex_unlock(&client->lock);
+	uring_feed_starved(client->reactor);
+}
+
+
+void uring_starve(Client *client, int flow){
+	//Queue The Session Once No Matter How Many Of Its Reads Starved
+	if(client->starved_flows == 0){
+		client->starved_next = client->reactor->starved;
+		client->reactor->starved = client;
+	}
+	client->starved_flows |= 1 << flow;
+}
+
+
+void uring_feed_starved(Reactor *reactor){
+	Client *client;
+	
+	//A Returned Buffer Restarts The Reads Of One Waiting Session
+	if((client = reactor->starved) == NULL){
+		return;
+	}
+	pthread_mutex_lock(&client->lock);
+	reactor->starved = client->starved_next;
+	for(int flow = 0; flow < URING_FLOWS; flow++){
+		if((client->starved_flows & (1 << flow)) && uring_read_flow(client, flow) == -1){
+			client->starved_flows = 0;
+			terminate_client(client->client_fd, client->master_fd, MARK);
+			return;
+		}
+	}
+	client->starved_flows = 0;
+	pthread_mutex_unlock(&client->lock);
+}
+
+
+void uring_cancel_session(Client *client){
+	Reactor *reactor = client->reactor;
+	Client **link;
+	struct io_uring_sqe *sqe;
+	
+	//A Recycled Slot Must Not Stay Linked On The Starved List
+	if(client->starved_flows != 0){
+		for(link = &reactor->starved; *link != client; link = &(*link)->starved_next);
+		*link = client->starved_next;
+		client->starved_flows = 0;
+	}
+	
+	//Cancellation Resolves Descriptors At Submission So It Must Go Out Before Close
+	int fds[URING_FLOWS] = {client->client_fd, client->master_fd};
+	for(int index = 0; index < URING_FLOWS; index++){
+		if(fds[index] != -1 && (sqe = uring_get_sqe(&reactor->uring)) != NULL){
+			uring_prep_cancel(sqe, fds[index], URING_DATA(OP_CANCEL, 0, 0, 0, 0));
+		}
+	}
+	uring_submit(&reactor->uring, 0);
+}
+
+
+int uring_watch(Reactor *reactor, int source_fd, uint32_t events){
+	struct io_uring_sqe *sqe;
+	Client *client = session_client(source_fd);
+	
+	//One Shot Poll Mirrors EPOLLONESHOT, The Handshake Runs The Usual State Machine
+	if((sqe = uring_get_sqe(&reactor->uring)) == NULL){
+		perror("\nIn Function (uring_watch), Error Getting A Submission Entry."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	uring_prep_poll(sqe, source_fd, events, client == NULL ? URING_DATA(OP_POLL, 0, 0, 0, 0) :
+					uring_data(client, OP_POLL, 0, 0));
+	return 0;
+}
+
+
+int uring_start_relay(Client *client){
+	//Each Direction Keeps Exactly One Read Or Write Outstanding
+	if(uring_read_flow(client, FLOW_TO_PTY) == -1 || uring_read_flow(client, FLOW_TO_SOCKET) == -1){
+		perror("\nIn Function (uring_start_relay), Error Submitting The First Reads."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	return 0;
+}
+
+
+int uring_read_flow(Client *client, int flow){
+	struct io_uring_sqe *sqe;
+	int source_fd = flow == FLOW_TO_PTY ? client->client_fd : client->master_fd;
+	
+	if((sqe = uring_get_sqe(&client->reactor->uring)) == NULL){
 		return -1;
 	}
+	uring_prep_read(sqe, source_fd, client->reactor->uring.buf_size, uring_data(client, OP_READ, flow, 0));
+	return 0;
+}
+
+
+int uring_write_flow(Client *client, int flow, unsigned bid){
+	Uring *ring = &client->reactor->uring;
+	struct io_uring_sqe *sqe;
+	int dest_fd = flow == FLOW_TO_PTY ? client->master_fd : client->client_fd;
+	uint32_t sent = client->flow_sent[flow];
 	
-	//Set Up Timer Length
-	time_specs.it_interval.tv_sec = 0;
-	time_specs.it_interval.tv_nsec = 0;
-	time_specs.it_value.tv_sec = MAX_TIMER_AMOUNT;
-	time_specs.it_value.tv_nsec = 0;
+	//The Write Is Linked Ahead Of The Next Read So Both Go Out In One Submission
+	if((sqe = uring_get_sqe(ring)) == NULL){
+		return -1;
+	}
+	uring_prep_write(sqe, dest_fd, uring_buffer(ring, bid) + sent, client->flow_length[flow] - sent,
+					 uring_data(client, OP_WRITE, flow, bid));
+	sqe->flags |= IOSQE_IO_LINK;
+	return uring_read_flow(client, flow);
+}
+
+
+int uring_arm_accept(Reactor *reactor){
+	struct io_uring_sqe *sqe;
 	
-	//Set Timer Length
-	if(timerfd_settime(timer_fd, 0, &time_specs, NULL) == -1){
-		perror("In Function (create_timer), Failed To Set The Time Parameters For The"
-			   " FD Timer. Failure To Set The Timer Parameters Results In"
-			   " Disconnection Of The Client.\n\tNOTE: This Error Exits The"
-			   " Corresponding Function.");
+	if((sqe = uring_get_sqe(&reactor->uring)) == NULL){
 		return -1;
 	}
-	return timer_fd;
+	uring_prep_accept(sqe, reactor->server_fd, SOCK_CLOEXEC | SOCK_NONBLOCK, URING_DATA(OP_ACCEPT, 0, 0, 0, 0));
+	return 0;
+}
+
+
+uint64_t uring_data(Client *client, Uring_Op op, int flow, unsigned bid){
+	return URING_DATA(op, flow, bid, client - client_slab + 1, client->generation);
 }
@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/resource.h>
+#include "session_table.h"
+
+//Chunks Are Allocated On First Use And Never Move
+static _Atomic(Session_Entry *) *session_chunks;
+static size_t chunk_count;
+static pthread_mutex_t chunk_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+
+int session_table_init(){
+	struct rlimit limit;
+	
+	//Only The Chunk Directory Is Sized Up Front, From The Descriptor Limit
+	if(getrlimit(RLIMIT_NOFILE, &limit) == -1 || limit.rlim_cur == RLIM_INFINITY){
+		limit.rlim_cur = 1 << 20;
+	}
+	chunk_count = (limit.rlim_cur + SESSION_CHUNK_SIZE - 1) / SESSION_CHUNK_SIZE;
+	
+	if((session_chunks = calloc(chunk_count, sizeof(*session_chunks))) == NULL){
+		perror("\nIn Function (session_table_init), Error Allocating The Session Table"
+			   " Directory. NOTE: This Error Exits The Corresponding Function.\n");
+		return -1;
+	}
+	return 0;
+}
+
+
+Session_Entry *session_lookup(int fd){
+	Session_Entry *chunk;
+	
+	if(fd < 0 || (size_t) (fd >> SESSION_CHUNK_BITS) >= chunk_count){
+		return NULL;
+	}
+	if((chunk = atomic_load_explicit(&session_chunks[fd >> SESSION_CHUNK_BITS],
+									 memory_order_acquire)) == NULL){
+		return NULL;
+	}
+	return &chunk[fd & (SESSION_CHUNK_SIZE - 1)];
+}
+
+
+int session_map(int fd, int peer_fd, uint32_t slot, uint8_t state, uint16_t home){
+	Session_Entry *entry;
+	
+	//Grow The Table By One Chunk When A Descriptor Lands Past The Mapped Range
+	if((entry = session_lookup(fd)) == NULL){
+		if(fd < 0 || (size_t) (fd >> SESSION_CHUNK_BITS) >= chunk_count){
+			return -1;
+		}
+		
+		pthread_mutex_lock(&chunk_mtx);
+		if(atomic_load(&session_chunks[fd >> SESSION_CHUNK_BITS]) == NULL){
+			Session_Entry *chunk = calloc(SESSION_CHUNK_SIZE, sizeof(Session_Entry));
+			if(chunk == NULL){
+				pthread_mutex_unlock(&chunk_mtx);
+				perror("\nIn Function (session_map), Error Growing The Session Table."
+					   " NOTE: This Error Exits The Corresponding Function.\n");
+				return -1;
+			}
+			atomic_store_explicit(&session_chunks[fd >> SESSION_CHUNK_BITS], chunk,
+								  memory_order_release);
+		}
+		pthread_mutex_unlock(&chunk_mtx);
+		entry = session_lookup(fd);
+	}
+	
+	entry->peer_fd = peer_fd;
+	entry->state = state;
+	entry->home = home;
+	entry->bulk = 0;
+	entry->channel = 0;
+	atomic_store(&entry->fired, 0);
+	entry->slot = slot;
+	return 0;
+}
+
+
+void session_unmap(int fd){
+	Session_Entry *entry;
+	
+	if((entry = session_lookup(fd)) != NULL){
+		entry->slot = SESSION_UNMAPPED;
+		entry->peer_fd = fd;
+	}
+}
+
+
+int session_affinity(int fd){
+	Session_Entry *entry = session_lookup(fd);
+	
+	if(entry == NULL || entry->slot == SESSION_UNMAPPED){
+		return fd;
+	}
+	
+	//Placed Sessions Name Their Worker, Otherwise Both Descriptors Share The Lower One
+	if(entry->home != 0){
+		return entry->home - 1;
+	}
+	return entry->peer_fd > fd ? fd : entry->peer_fd;
+}
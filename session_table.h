@@ -0,0 +1,29 @@
+#ifndef SESSION_TABLE_H
+#define SESSION_TABLE_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define SESSION_CHUNK_BITS 12
+#define SESSION_CHUNK_SIZE (1 << SESSION_CHUNK_BITS)
+#define SESSION_UNMAPPED 0
+
+//Hot Per Descriptor Fields Packed So Dispatch Reads One Cache Line
+typedef struct session_entry_t {
+	int32_t peer_fd;	//Other Descriptor Of The Session, Itself Before Pairing
+	uint32_t slot;		//Client Slab Index Plus One, Zero When Unmapped
+	uint8_t state;		//Mirror Of The Client State For Lock Free Routing
+	uint8_t bulk;		//The Last Relay Pass Reading This Descriptor Moved Bulk Data
+	uint16_t home;		//Pool Worker Plus One That Owns The Session, Zero When Unplaced
+	uint16_t channel;	//Multiplexed Channel Of A PTY Master Sharing Its Connection's Slot
+	atomic_uchar fired;	//Edge Triggered Event Not Yet Taken By A Multiplexed Pass
+} Session_Entry;
+
+//Function Prototypes
+int session_table_init();
+Session_Entry *session_lookup(int fd);
+int session_map(int fd, int peer_fd, uint32_t slot, uint8_t state, uint16_t home);
+void session_unmap(int fd);
+int session_affinity(int fd);
+
+#endif
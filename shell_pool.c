@@ -0,0 +1,158 @@
+#define _XOPEN_SOURCE 600
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include "shell_pool.h"
+
+#define SLAVE_NAME_MAX 128
+
+//Local Function Prototypes
+static void run_helper(int size, Shell_Launcher launch);
+static int send_shell(Shell_Launcher launch);
+
+//Server End Of The Helper Channel, -1 When The Pool Is Disabled
+static int pool_fd = -1;
+
+
+int shell_pool_start(int size, Shell_Launcher launch){
+	int channel[2];
+	
+	//Sequenced Packets Keep Every Descriptor On Its Own Message
+	if(socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, channel) == -1){
+		perror("\nIn Function (shell_pool_start), Error Creating The Shell Pool Channel."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	
+	//Fork The Helper While The Server Is Still Small And Single Threaded
+	switch(fork()){
+		case 0:
+			close(channel[0]);
+			pool_fd = channel[1];
+			run_helper(size, launch);
+			exit(EXIT_SUCCESS);
+		case -1:
+			perror("\nIn Function (shell_pool_start), Error Forking The Shell Pool Helper."
+				   " NOTE: This Error Exits The Corresponding Function.");
+			close(channel[0]);
+			close(channel[1]);
+			return -1;
+	}
+	close(channel[1]);
+	pool_fd = channel[0];
+	return 0;
+}
+
+
+int shell_pool_claim(){
+	char tag, control[CMSG_SPACE(sizeof(int))];
+	struct iovec iov = {&tag, sizeof(tag)};
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+	int master_fd;
+	
+	if(pool_fd == -1){
+		return -1;
+	}
+	
+	//An Empty Pool Sends The Caller Down The Spawning Path Instead Of Waiting
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+	if(recvmsg(pool_fd, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC) <= 0){
+		return -1;
+	}
+	if((cmsg = CMSG_FIRSTHDR(&msg)) == NULL || cmsg->cmsg_type != SCM_RIGHTS){
+		return -1;
+	}
+	memcpy(&master_fd, CMSG_DATA(cmsg), sizeof(master_fd));
+	
+	//Every Claim Asks The Helper For One Replacement
+	if(send(pool_fd, &tag, sizeof(tag), MSG_DONTWAIT) == -1){
+		perror("\nIn Function (shell_pool_claim), Error Requesting A Replacement Shell."
+			   " NOTE: The Pool Shrinks By One Shell.");
+	}
+	return master_fd;
+}
+
+
+static void run_helper(int size, Shell_Launcher launch){
+	char request;
+	
+	//Fill The Pool, Then Replace Each Shell As The Server Claims It
+	for(int index = 0; index < size; index++){
+		if(send_shell(launch) == -1){
+			exit(EXIT_FAILURE);
+		}
+	}
+	while(read(pool_fd, &request, sizeof(request)) == sizeof(request)){
+		if(send_shell(launch) == -1){
+			exit(EXIT_FAILURE);
+		}
+	}
+	
+	//Server Exited, Queued Masters Close With The Channel
+}
+
+
+static int send_shell(Shell_Launcher launch){
+	char slave_name[SLAVE_NAME_MAX], tag = 0, control[CMSG_SPACE(sizeof(int))];
+	struct iovec iov = {&tag, sizeof(tag)};
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+	char *slave_temp;
+	int master_fd;
+	
+	//Master Is Made Nonblocking Here, The Flag Travels With The Open File
+	if((master_fd = posix_openpt(O_RDWR | O_NOCTTY)) == -1 ||
+	   fcntl(master_fd, F_SETFL, fcntl(master_fd, F_GETFL) | O_NONBLOCK) == -1 ||
+	   unlockpt(master_fd) == -1 || (slave_temp = ptsname(master_fd)) == NULL ||
+	   strlen(slave_temp) >= SLAVE_NAME_MAX){
+		perror("\nIn Function (send_shell), Error Opening A PTY For A Pooled Shell."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	strcpy(slave_name, slave_temp);
+	
+	//Shell Starts Now So Its Prompt Is Already Waiting When A Session Claims It
+	switch(fork()){
+		case 0:
+			close(pool_fd);
+			close(master_fd);
+			launch(slave_name);
+			exit(EXIT_FAILURE);
+		case -1:
+			perror("\nIn Function (send_shell), Error Forking A Pooled Shell."
+				   " NOTE: This Error Exits The Corresponding Function.");
+			close(master_fd);
+			return -1;
+	}
+	
+	//Pass The Master To The Server And Drop The Helper's Copy
+	memset(&msg, 0, sizeof(msg));
+	memset(control, 0, sizeof(control));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(cmsg), &master_fd, sizeof(master_fd));
+	if(sendmsg(pool_fd, &msg, 0) == -1){
+		perror("\nIn Function (send_shell), Error Passing A Pooled Shell To The Server."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		close(master_fd);
+		return -1;
+	}
+	close(master_fd);
+	return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef SHELL_POOL_H
+#define SHELL_POOL_H
+
+//Runs In The Child With The PTY Slave Name And Never Returns
+typedef void (*Shell_Launcher)(char *slave_name);
+
+//Function Prototypes
+int shell_pool_start(int size, Shell_Launcher launch);
+int shell_pool_claim();
+
+#endif
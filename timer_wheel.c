@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/timerfd.h>
+#include "timer_wheel.h"
+
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_SPAN ((uint64_t) 1 << (WHEEL_BITS * WHEEL_LEVELS))
+
+//Local Function Prototypes
+static void link_timer(Timer_Wheel *wheel, Wheel_Timer *timer);
+static void unlink_timer(Wheel_Timer *timer);
+static void cascade(Timer_Wheel *wheel, int level);
+static int set_ticking(Timer_Wheel *wheel, int ticking);
+
+
+int wheel_init(Timer_Wheel *wheel){
+	memset(wheel->slots, 0, sizeof(wheel->slots));
+	atomic_init(&wheel->now, 0);
+	wheel->pending = 0;
+	pthread_mutex_init(&wheel->lock, NULL);
+	
+	//One Timer Descriptor Drives Every Timeout On The Event Loop
+	if((wheel->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK)) == -1){
+		perror("In Function (wheel_init), Failed To Create FD Timer To Drive The Timer"
+			   " Wheel. \n\tNOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	return 0;
+}
+
+
+uint64_t wheel_now(Timer_Wheel *wheel){
+	return atomic_load_explicit(&wheel->now, memory_order_relaxed);
+}
+
+
+uint64_t wheel_ticks(unsigned int seconds){
+	return (uint64_t) seconds * 1000 / WHEEL_TICK_MS;
+}
+
+
+static int set_ticking(Timer_Wheel *wheel, int ticking){
+	struct itimerspec time_specs;
+	
+	//Tick Only While Timers Are Pending So An Idle Server Stays Asleep
+	time_specs.it_interval.tv_sec = 0;
+	time_specs.it_interval.tv_nsec = ticking ? WHEEL_TICK_MS * 1000000L : 0;
+	time_specs.it_value = time_specs.it_interval;
+	
+	if(timerfd_settime(wheel->timer_fd, 0, &time_specs, NULL) == -1){
+		perror("In Function (set_ticking), Failed To Set The Time Parameters For The"
+			   " Timer Wheel.\n\tNOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	return 0;
+}
+
+
+static void link_timer(Timer_Wheel *wheel, Wheel_Timer *timer){
+	uint64_t now = wheel_now(wheel);
+	uint64_t delta;
+	int level = 0;
+	
+	//Clamp Deadlines Into The Range The Wheel Can Represent
+	if(timer->expires < now){
+		timer->expires = now;
+	}
+	if((delta = timer->expires - now) >= WHEEL_SPAN){
+		timer->expires = now + WHEEL_SPAN - 1;
+		delta = WHEEL_SPAN - 1;
+	}
+	
+	//Coarser Levels Hold Deadlines Further Out
+	while(level < WHEEL_LEVELS - 1 && delta >= ((uint64_t) 1 << (WHEEL_BITS * (level + 1)))){
+		level++;
+	}
+	
+	Wheel_Timer **slot = &wheel->slots[level][(timer->expires >> (WHEEL_BITS * level)) & WHEEL_MASK];
+	timer->next = *slot;
+	if(*slot != NULL){
+		(*slot)->pprev = &timer->next;
+	}
+	timer->pprev = slot;
+	*slot = timer;
+}
+
+
+static void unlink_timer(Wheel_Timer *timer){
+	*timer->pprev = timer->next;
+	if(timer->next != NULL){
+		timer->next->pprev = timer->pprev;
+	}
+	timer->next = NULL;
+	timer->pprev = NULL;
+}
+
+
+int wheel_schedule(Timer_Wheel *wheel, Wheel_Timer *timer, uint64_t ticks){
+	int result = 0;
+	
+	pthread_mutex_lock(&wheel->lock);
+	
+	//Rescheduling Is A Cancel Followed By An Insert
+	if(timer->pprev != NULL){
+		unlink_timer(timer);
+		wheel->pending--;
+	}
+	timer->expires = wheel_now(wheel) + (ticks > 0 ? ticks : 1);
+	link_timer(wheel, timer);
+	
+	if(wheel->pending++ == 0){
+		result = set_ticking(wheel, 1);
+	}
+	pthread_mutex_unlock(&wheel->lock);
+	return result;
+}
+
+
+void wheel_cancel(Timer_Wheel *wheel, Wheel_Timer *timer){
+	pthread_mutex_lock(&wheel->lock);
+	if(timer->pprev != NULL){
+		unlink_timer(timer);
+		wheel->pending--;
+	}
+	pthread_mutex_unlock(&wheel->lock);
+}
+
+
+static void cascade(Timer_Wheel *wheel, int level){
+	uint64_t now = wheel_now(wheel);
+	Wheel_Timer *timer = wheel->slots[level][(now >> (WHEEL_BITS * level)) & WHEEL_MASK];
+	Wheel_Timer *next;
+	
+	//Redistribute A Coarse Slot Into The Finer Levels Below It
+	wheel->slots[level][(now >> (WHEEL_BITS * level)) & WHEEL_MASK] = NULL;
+	for(; timer != NULL; timer = next){
+		next = timer->next;
+		link_timer(wheel, timer);
+	}
+}
+
+
+Wheel_Timer *wheel_advance(Timer_Wheel *wheel, Wheel_Claim claim){
+	uint64_t expirations, now;
+	Wheel_Timer *fired = NULL, *retry = NULL, *timer, *next;
+	ssize_t count;
+	
+	//Every Expiration Of The Periodic Timer Is One Tick
+	if((count = read(wheel->timer_fd, &expirations, sizeof(expirations))) != sizeof(expirations)){
+		return NULL;
+	}
+	
+	pthread_mutex_lock(&wheel->lock);
+	while(expirations-- > 0 && wheel->pending > 0){
+		now = atomic_fetch_add_explicit(&wheel->now, 1, memory_order_relaxed) + 1;
+		
+		//Cascade From The Highest Level Whose Finer Levels Just Wrapped
+		int top = 0;
+		while(top < WHEEL_LEVELS - 1 && (now & (((uint64_t) 1 << (WHEEL_BITS * (top + 1))) - 1)) == 0){
+			top++;
+		}
+		for(int level = top; level > 0; level--){
+			cascade(wheel, level);
+		}
+		
+		//Everything In The Current Finest Slot Is Due
+		Wheel_Timer **slot = &wheel->slots[0][now & WHEEL_MASK];
+		for(timer = *slot, *slot = NULL; timer != NULL; timer = next){
+			next = timer->next;
+			timer->pprev = NULL;
+			wheel->pending--;
+			
+			//Owners That Are Busy Are Retried On The Next Tick
+			if(claim(timer) == 0){
+				timer->next = fired;
+				fired = timer;
+			}else{
+				timer->next = retry;
+				retry = timer;
+			}
+		}
+		for(timer = retry; timer != NULL; timer = next){
+			next = timer->next;
+			timer->expires = now + 1;
+			link_timer(wheel, timer);
+			wheel->pending++;
+		}
+		retry = NULL;
+	}
+	
+	if(wheel->pending == 0){
+		set_ticking(wheel, 0);
+	}
+	pthread_mutex_unlock(&wheel->lock);
+	
+	//Fired Timers Are Unlinked And Their Owners Were Claimed
+	for(timer = fired; timer != NULL; timer = timer->next){
+		timer->pprev = NULL;
+	}
+	return fired;
+}
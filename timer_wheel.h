@@ -0,0 +1,41 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_LEVELS 4
+#define WHEEL_TICK_MS 100
+
+//Intrusive Timer Entry Embedded In Its Owner
+typedef struct wheel_timer_t {
+	struct wheel_timer_t *next;
+	struct wheel_timer_t **pprev;	//NULL While Not Scheduled
+	uint64_t expires;				//Absolute Tick
+	int kind;
+} Wheel_Timer;
+
+//Hierarchical Timing Wheel Declaration
+typedef struct timer_wheel_t {
+	pthread_mutex_t lock;
+	_Atomic uint64_t now;		//Ticks Elapsed While Timers Were Pending
+	int timer_fd;
+	int pending;
+	Wheel_Timer *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+} Timer_Wheel;
+
+//Claim Callback, Runs Under The Wheel Lock And Returns -1 To Retry Next Tick
+typedef int (*Wheel_Claim)(Wheel_Timer *timer);
+
+//Function Prototypes
+int wheel_init(Timer_Wheel *wheel);
+uint64_t wheel_now(Timer_Wheel *wheel);
+uint64_t wheel_ticks(unsigned int seconds);
+int wheel_schedule(Timer_Wheel *wheel, Wheel_Timer *timer, uint64_t ticks);
+void wheel_cancel(Timer_Wheel *wheel, Wheel_Timer *timer);
+Wheel_Timer *wheel_advance(Timer_Wheel *wheel, Wheel_Claim claim);
+
+#endif
@@ -0,0 +1,161 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include "topology.h"
+
+//Usable CPUs Ordered Node By Node So Neighbouring Indices Share A Node
+static int cpu_order[TOPOLOGY_MAX_CPUS];
+static int cpu_count;
+static signed char cpu_nodes[TOPOLOGY_MAX_CPUS];	//Dense Node Index, -1 Until Seen
+static int node_ids[TOPOLOGY_MAX_NODES];	//Kernel Node Number Of Each Dense Index
+static int node_count;
+
+//Local Function Prototypes
+static void add_cpu(int cpu, int node, const cpu_set_t *allowed);
+static void read_cpulist(const char *list, int node, const cpu_set_t *allowed);
+
+
+int topology_init(){
+	cpu_set_t allowed;
+	char path[64], list[4096];
+	FILE *file;
+
+	//Only CPUs This Process May Run On Take Part In Placement
+	if(sched_getaffinity(0, sizeof(allowed), &allowed) == -1){
+		perror("\nIn Function (topology_init), Error Reading The Process CPU Mask."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	memset(cpu_nodes, -1, sizeof(cpu_nodes));
+	cpu_count = node_count = 0;
+
+	//Node Numbers May Be Sparse, Each One Lists Its CPUs As Ranges
+	for(int id = 0; id < TOPOLOGY_MAX_NODES; id++){
+		snprintf(path, sizeof(path), TOPOLOGY_NODE_PATH "/node%d/cpulist", id);
+		if((file = fopen(path, "r")) == NULL){
+			continue;
+		}
+		int before = cpu_count;
+		if(fgets(list, sizeof(list), file) != NULL){
+			read_cpulist(list, node_count, &allowed);
+		}
+		fclose(file);
+
+		//Memory Only Nodes And Nodes Outside The Mask Get No Index
+		if(cpu_count > before){
+			node_ids[node_count++] = id;
+		}
+	}
+
+	//Without NUMA Information Every Allowed CPU Belongs To Node Zero
+	if(node_count == 0){
+		node_ids[node_count++] = 0;
+	}
+	for(int cpu = 0; cpu < TOPOLOGY_MAX_CPUS; cpu++){
+		add_cpu(cpu, 0, &allowed);
+	}
+	if(cpu_count == 0){
+		fprintf(stderr, "\nIn Function (topology_init), No Usable CPU Was Found."
+				" NOTE: This Error Exits The Corresponding Function.\n");
+		return -1;
+	}
+	return 0;
+}
+
+
+static void read_cpulist(const char *list, int node, const cpu_set_t *allowed){
+	char *end;
+
+	//Lists Look Like 0-3,8-11
+	while(*list >= '0' && *list <= '9'){
+		long first = strtol(list, &end, 10), last = first;
+		if(*end == '-'){
+			last = strtol(end + 1, &end, 10);
+		}
+		for(long cpu = first; cpu <= last && cpu < TOPOLOGY_MAX_CPUS; cpu++){
+			add_cpu(cpu, node, allowed);
+		}
+		list = *end == ',' ? end + 1 : end;
+	}
+}
+
+
+static void add_cpu(int cpu, int node, const cpu_set_t *allowed){
+	if(cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, allowed) || cpu_nodes[cpu] != -1){
+		return;
+	}
+	cpu_nodes[cpu] = node;
+	cpu_order[cpu_count++] = cpu;
+}
+
+
+int topology_cpus(){
+	return cpu_count;
+}
+
+
+int topology_nodes(){
+	return node_count;
+}
+
+
+int topology_cpu(int index){
+	//Wraps So Callers May Place More Threads Than There Are CPUs
+	return cpu_order[index % cpu_count];
+}
+
+
+int topology_node(int cpu){
+	if(cpu < 0 || cpu >= TOPOLOGY_MAX_CPUS || cpu_nodes[cpu] == -1){
+		return 0;
+	}
+	return cpu_nodes[cpu];
+}
+
+
+int topology_pin(pthread_attr_t *attr, int cpu){
+	cpu_set_t single;
+	int result;
+
+	CPU_ZERO(&single);
+	CPU_SET(cpu, &single);
+
+	//Threads Not Yet Created Start Pinned So Their Stacks Are Touched Locally
+	result = attr != NULL ? pthread_attr_setaffinity_np(attr, sizeof(single), &single) :
+							pthread_setaffinity_np(pthread_self(), sizeof(single), &single);
+	if(result != 0){
+		fprintf(stderr, "\nIn Function (topology_pin), Error Pinning A Thread To CPU %d: %s."
+				" NOTE: This Error Exits The Corresponding Function.\n", cpu, strerror(result));
+		return -1;
+	}
+	return 0;
+}
+
+
+int topology_bind(void *address, size_t length, int node){
+	uintptr_t page = sysconf(_SC_PAGESIZE);
+	uintptr_t start = ((uintptr_t) address + page - 1) & ~(page - 1);
+	uintptr_t end = ((uintptr_t) address + length) & ~(page - 1);
+	unsigned long mask = 1ul << node_ids[node];
+
+	//Only Whole Pages Can Carry A Policy, Partial Ones Keep First Touch Placement
+	if(end <= start){
+		return 0;
+	}
+
+	//Preferred Rather Than Bound So A Full Node Spills Instead Of Failing
+	if(syscall(SYS_mbind, start, end - start, MPOL_PREFERRED, &mask,
+			   sizeof(mask) * 8 + 1, MPOL_MF_MOVE) == -1){
+		perror("\nIn Function (topology_bind), Error Binding Memory To Its NUMA Node."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,20 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+#define TOPOLOGY_MAX_CPUS 1024
+#define TOPOLOGY_MAX_NODES 64
+#define TOPOLOGY_NODE_PATH "/sys/devices/system/node"
+
+//Function Prototypes
+int topology_init();
+int topology_cpus();
+int topology_nodes();
+int topology_cpu(int index);
+int topology_node(int cpu);
+int topology_pin(pthread_attr_t *attr, int cpu);
+int topology_bind(void *address, size_t length, int node);
+
+#endif
@@ -1,13 +1,51 @@
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <pthread.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
 #include "tpool.h"
+#include "metrics.h"
+#include "topology.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define cpu_relax() __builtin_ia32_pause()
+#else
+#define cpu_relax() atomic_signal_fence(memory_order_seq_cst)
+#endif
 
 //Local Function Prototypes
-static int enqueue_task(int job);
-static int dequeue_task();
-static void *tpool_remove_task();
+static int enqueue_tasks(int *jobs, int count, uint64_t stamp);
+static int dequeue_task(int *job, uint64_t *stamp);
+static int futex_wait(atomic_uint *word, unsigned int expected, uint64_t timeout);
+static void futex_wake(atomic_uint *word, int count);
+static void fifo_init(tpool_fifo_t *fifo);
+static int fifo_push(tpool_fifo_t *fifo, int *jobs, int count, uint64_t stamp);
+static int fifo_pop(tpool_fifo_t *fifo, int *job, uint64_t *stamp);
+static int take_setup(int *job, uint64_t *stamp);
+static int deque_push(tpool_deque_t *deque, int job, uint64_t stamp, int urgent);
+static int deque_pop_front(tpool_deque_t *deque, int *job, uint64_t *stamp);
+static int deque_steal_back(tpool_deque_t *deque, int *job, uint64_t *stamp);
+static int find_task(int worker, int *job, uint64_t *stamp, int turn, int *setup);
+static int take_task(int *job, uint64_t *stamp, int turn, int *setup);
+static void wake_deque_owners(char *touched);
+static void wake_thieves(int count);
+static void wake_workers(int count);
+static void wait_for_free_slot(unsigned int seq);
+static void signal_free_slot();
+static int start_worker(int index);
+static void grow_pool(uint64_t since, uint64_t now);
+static int retire_worker(int worker);
+static void run_task(int job, uint64_t stamp, int setup);
+static void *tpool_remove_task(void *arg);
+static void *tpool_steal_task(void *arg);
 
 //Thread Pool Object
 tpool_t thrpool;
@@ -19,62 +57,467 @@ int QUEUE_MAX;
 void print_queue(){
 	
 	for(int index = 0; index < QUEUE_MAX; index++){
-		printf(" %d ", thrpool.job_queue[index]);
+		printf(" %d ", thrpool.job_queue[index].job);
 	}
 	printf("\n");
 }
 
 
-static int enqueue_task(int job){
+static int enqueue_tasks(int *jobs, int count, uint64_t stamp){
+	tpool_slot_t *slot;
+	int reserved;
+	size_t pos = atomic_load_explicit(&thrpool.queue_head, memory_order_relaxed);
+	
+	//Reserve A Run Of Consumed Slots At The Head With A Single Exchange
+	while(1){
+		for(reserved = 0; reserved < count; reserved++){
+			slot = &thrpool.job_queue[(pos + reserved) & thrpool.queue_mask];
+			if(atomic_load_explicit(&slot->sequence, memory_order_acquire) != pos + reserved){
+				break;
+			}
+		}
+		
+		if(reserved == 0){
+			slot = &thrpool.job_queue[pos & thrpool.queue_mask];
+			size_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+			if((intptr_t) seq - (intptr_t) pos < 0){
+				return 0;	//Queue Full
+			}
+			pos = atomic_load_explicit(&thrpool.queue_head, memory_order_relaxed);
+		}else if(atomic_compare_exchange_weak_explicit(&thrpool.queue_head, &pos, pos + reserved,
+														memory_order_relaxed, memory_order_relaxed)){
+			break;
+		}
+	}
+	
+	//Publish Each Reserved Job To Consumers
+	for(int index = 0; index < reserved; index++){
+		slot = &thrpool.job_queue[(pos + index) & thrpool.queue_mask];
+		slot->job = jobs[index];
+		slot->enqueued = stamp;
+		atomic_store_explicit(&slot->sequence, pos + index + 1, memory_order_release);
+	}
+	return reserved;
+}
+
+
+static int dequeue_task(int *job, uint64_t *stamp){
+	tpool_slot_t *slot;
+	size_t pos = atomic_load_explicit(&thrpool.queue_tail, memory_order_relaxed);
+	
+	//Claim The Tail Slot Once Its Sequence Shows It Was Published
+	while(1){
+		slot = &thrpool.job_queue[pos & thrpool.queue_mask];
+		size_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+		intptr_t diff = (intptr_t) seq - (intptr_t) (pos + 1);
+		
+		if(diff == 0){
+			if(atomic_compare_exchange_weak_explicit(&thrpool.queue_tail, &pos, pos + 1,
+													 memory_order_relaxed, memory_order_relaxed)){
+				break;
+			}
+		}else if(diff < 0){
+			return -1;	//Queue Empty
+		}else{
+			pos = atomic_load_explicit(&thrpool.queue_tail, memory_order_relaxed);
+		}
+	}
+	
+	//Hand The Slot Back To Producers One Lap Ahead
+	*job = slot->job;
+	*stamp = slot->enqueued;
+	atomic_store_explicit(&slot->sequence, pos + thrpool.queue_mask + 1, memory_order_release);
+	return 0;
+}
+
+
+static int futex_wait(atomic_uint *word, unsigned int expected, uint64_t timeout){
+	struct timespec limit = {timeout / 1000000000, timeout % 1000000000};
+	
+	//Relative Timeout, Zero Waits Until Woken
+	if(syscall(SYS_futex, (unsigned int *) word, FUTEX_WAIT_PRIVATE, expected,
+			   timeout > 0 ? &limit : NULL, NULL, 0) == -1 && errno == ETIMEDOUT){
+		return -1;
+	}
+	return 0;
+}
+
+
+static void futex_wake(atomic_uint *word, int count){
+	syscall(SYS_futex, (unsigned int *) word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+
+static void fifo_init(tpool_fifo_t *fifo){
+	//Starts Empty And Allocates On First Use
+	pthread_mutex_init(&fifo->lock, NULL);
+	fifo->entries = NULL;
+	fifo->capacity = fifo->front = fifo->count = 0;
+	atomic_init(&fifo->pending, 0);
+}
+
+
+static int fifo_push(tpool_fifo_t *fifo, int *jobs, int count, uint64_t stamp){
+	pthread_mutex_lock(&fifo->lock);
 	
-	thrpool.job_queue[thrpool.queue_head] = job;
-	thrpool.queue_head = (thrpool.queue_head + 1) % QUEUE_MAX;
+	//Double The Ring, Unwrapping The Old Contents To The Start
+	if(fifo->count + count > fifo->capacity){
+		size_t capacity = fifo->capacity > 0 ? fifo->capacity : TPOOL_FIFO_INITIAL;
+		while(capacity < fifo->count + count){
+			capacity <<= 1;
+		}
+		tpool_entry_t *entries = malloc(sizeof(tpool_entry_t) * capacity);
+		if(entries == NULL){
+			pthread_mutex_unlock(&fifo->lock);
+			return -1;
+		}
+		for(size_t index = 0; index < fifo->count; index++){
+			entries[index] = fifo->entries[(fifo->front + index) & (fifo->capacity - 1)];
+		}
+		free(fifo->entries);
+		fifo->entries = entries;
+		fifo->capacity = capacity;
+		fifo->front = 0;
+	}
+	
+	for(int index = 0; index < count; index++){
+		tpool_entry_t *entry = &fifo->entries[(fifo->front + fifo->count++) & (fifo->capacity - 1)];
+		entry->job = jobs[index];
+		entry->enqueued = stamp;
+	}
+	atomic_store(&fifo->pending, fifo->count);
+	pthread_mutex_unlock(&fifo->lock);
 	return 0;
 }
 
 
-static int dequeue_task(){
+static int fifo_pop(tpool_fifo_t *fifo, int *job, uint64_t *stamp){
+	//Workers Check These Queues Often, So Their Empty Case Takes No Lock
+	if(atomic_load_explicit(&fifo->pending, memory_order_acquire) == 0){
+		return -1;
+	}
+	pthread_mutex_lock(&fifo->lock);
+	if(fifo->count == 0){
+		pthread_mutex_unlock(&fifo->lock);
+		return -1;
+	}
+	tpool_entry_t *entry = &fifo->entries[fifo->front];
+	*job = entry->job;
+	*stamp = entry->enqueued;
+	fifo->front = (fifo->front + 1) & (fifo->capacity - 1);
+	atomic_store(&fifo->pending, --fifo->count);
+	pthread_mutex_unlock(&fifo->lock);
+	return 0;
+}
+
+
+static int take_setup(int *job, uint64_t *stamp){
+	int limit = atomic_load(&thrpool.worker_count) / TPOOL_SETUP_SHARE;
 	
-	int temp_job = thrpool.job_queue[thrpool.queue_tail];
-	thrpool.job_queue[thrpool.queue_tail] = 0;
-	thrpool.queue_tail = (thrpool.queue_tail + 1) % QUEUE_MAX;
-	return temp_job;
+	//Setup Runs On A Bounded Share Of The Workers So fork Never Occupies All Of Them
+	if(atomic_load_explicit(&thrpool.setup.pending, memory_order_acquire) == 0){
+		return -1;
+	}
+	if(atomic_fetch_add(&thrpool.setup_running, 1) >= (limit > 0 ? limit : 1) ||
+	   fifo_pop(&thrpool.setup, job, stamp) == -1){
+		atomic_fetch_sub(&thrpool.setup_running, 1);
+		return -1;
+	}
+	return 0;
 }
 
 
-int tpool_init(void (*process_task) (int)){
+static int deque_push(tpool_deque_t *deque, int job, uint64_t stamp, int urgent){
+	size_t index;
+	
+	pthread_spin_lock(&deque->lock);
+	if(deque->back - deque->front > thrpool.queue_mask){
+		pthread_spin_unlock(&deque->lock);
+		return -1;	//Deque Full
+	}
+	
+	//Interactive Jobs Go Where The Owner Pops, Bulk Ones Where Thieves Take
+	index = urgent ? --deque->front : deque->back++;
+	deque->jobs[index & thrpool.queue_mask] = job;
+	deque->enqueued[index & thrpool.queue_mask] = stamp;
+	pthread_spin_unlock(&deque->lock);
+	return 0;
+}
+
+
+static int deque_pop_front(tpool_deque_t *deque, int *job, uint64_t *stamp){
+	pthread_spin_lock(&deque->lock);
+	if(deque->back == deque->front){
+		pthread_spin_unlock(&deque->lock);
+		return -1;	//Deque Empty
+	}
+	*job = deque->jobs[deque->front & thrpool.queue_mask];
+	*stamp = deque->enqueued[deque->front & thrpool.queue_mask];
+	deque->front++;
+	pthread_spin_unlock(&deque->lock);
+	return 0;
+}
+
+
+static int deque_steal_back(tpool_deque_t *deque, int *job, uint64_t *stamp){
+	//Skip Victims Whose Lock Is Busy Rather Than Queue Behind Them
+	if(pthread_spin_trylock(&deque->lock) != 0){
+		return -1;
+	}
+	if(deque->back == deque->front){
+		pthread_spin_unlock(&deque->lock);
+		return -1;	//Deque Empty
+	}
+	deque->back--;
+	*job = deque->jobs[deque->back & thrpool.queue_mask];
+	*stamp = deque->enqueued[deque->back & thrpool.queue_mask];
+	pthread_spin_unlock(&deque->lock);
+	return 0;
+}
+
+
+static int find_task(int worker, int *job, uint64_t *stamp, int turn, int *setup){
+	tpool_deque_t *own = &thrpool.deques[worker];
+	
+	//On Its Turn The Setup Lane, Then The Bulk Jobs At The Back, Go First
+	*setup = 0;
+	if(turn){
+		if(take_setup(job, stamp) == 0){
+			*setup = 1;
+			return 0;
+		}
+		if(deque_steal_back(own, job, stamp) == 0){
+			return 0;
+		}
+	}
+	
+	//Prefer The Local Deque To Keep Session State In This Core's Cache
+	if(deque_pop_front(own, job, stamp) == 0){
+		return 0;
+	}
+	
+	//Spilled Jobs Are The Oldest Waiting, So They Come Before Stealing
+	if(fifo_pop(&thrpool.overflow, job, stamp) == 0){
+		return 0;
+	}
+	
+	//Otherwise Steal From The Back Of The Other Workers, Same Node Before Remote Ones
+	int node = thrpool.deques[worker].node;
+	int slots = atomic_load(&thrpool.worker_slots);
+	for(int remote = 0; remote < 2; remote++){
+		for(int offset = 1; offset < slots; offset++){
+			tpool_deque_t *victim = &thrpool.deques[(worker + offset) % slots];
+			if((victim->node != node) == remote && deque_steal_back(victim, job, stamp) == 0){
+				return 0;
+			}
+		}
+	}
+	
+	//Setup Only Once Nothing Else Is Waiting, Within Its Share Of The Workers
+	if(take_setup(job, stamp) == 0){
+		*setup = 1;
+		return 0;
+	}
+	return -1;
+}
+
+
+static int take_task(int *job, uint64_t *stamp, int turn, int *setup){
+	//On Its Turn The Setup Lane, Then The Bulk Lane, Go First
+	*setup = 0;
+	if(turn){
+		if(take_setup(job, stamp) == 0){
+			*setup = 1;
+			return 0;
+		}
+		if(fifo_pop(&thrpool.bulk, job, stamp) == 0){
+			return 0;
+		}
+	}
+	
+	//Interactive Jobs, Including Spilled Ones, Run Ahead Of Bulk And Setup
+	if(dequeue_task(job, stamp) == 0 || fifo_pop(&thrpool.overflow, job, stamp) == 0 ||
+	   fifo_pop(&thrpool.bulk, job, stamp) == 0){
+		return 0;
+	}
+	if(take_setup(job, stamp) == 0){
+		*setup = 1;
+		return 0;
+	}
+	return -1;
+}
+
+
+static void wake_deque_owners(char *touched){
+	int busy_owners = 0;
+	int slots = atomic_load(&thrpool.worker_slots);
+	
+	//Wake Parked Owners Directly And Count The Ones Still Working Or Retired
+	for(int index = 0; index < slots; index++){
+		if(!touched[index]){
+			continue;
+		}
+		touched[index] = 0;
+		atomic_fetch_add(&thrpool.deques[index].wake_seq, 1);
+		if(atomic_load(&thrpool.deques[index].parked)){
+			futex_wake(&thrpool.deques[index].wake_seq, 1);
+		}else{
+			busy_owners++;
+		}
+	}
+	
+	//Jobs Behind Busy Owners Get One Parked Thief Each
+	wake_thieves(busy_owners);
+}
+
+
+static void wake_thieves(int count){
+	int slots = atomic_load(&thrpool.worker_slots);
+	
+	for(int index = 0; index < slots && count > 0; index++){
+		tpool_deque_t *thief = &thrpool.deques[index];
+		if(atomic_load(&thief->parked)){
+			atomic_fetch_add(&thief->wake_seq, 1);
+			futex_wake(&thief->wake_seq, 1);
+			count--;
+		}
+	}
+}
+
+
+static void wake_workers(int count){
+	//Wake No More Parked Workers Than There Are New Jobs
+	atomic_fetch_add(&thrpool.queue_avail_seq, 1);
+	int parked = atomic_load(&thrpool.parked_workers);
+	if(parked > 0){
+		futex_wake(&thrpool.queue_avail_seq, count < parked ? count : parked);
+	}
+}
+
+
+static void wait_for_free_slot(unsigned int seq){
+	atomic_fetch_add(&thrpool.parked_producers, 1);
+	if(seq == atomic_load(&thrpool.queue_free_seq)){
+		futex_wait(&thrpool.queue_free_seq, seq, 0);
+	}
+	atomic_fetch_sub(&thrpool.parked_producers, 1);
+}
+
+
+static void signal_free_slot(){
+	atomic_fetch_add(&thrpool.queue_free_seq, 1);
+	if(atomic_load(&thrpool.parked_producers) > 0){
+		futex_wake(&thrpool.queue_free_seq, 1);
+	}
+}
+
+
+void tpool_set_elastic(int min_workers, int max_workers, uint64_t wait_target){
+	//Zero Leaves A Bound At Its Default, Chosen From The CPU Count At Initialization
+	thrpool.min_workers = min_workers;
+	thrpool.max_workers = max_workers;
+	thrpool.wait_target = wait_target;
+}
+
+
+int tpool_init(void (*process_task) (int), tpool_mode_t mode, int placed){
 	
 	//Setup Process Task Function
 	thrpool.profunction = process_task;
+	thrpool.mode = mode;
 	
-	//Queue Size Constants
-	int const NUMBER_OF_WORKERS = sysconf(_SC_NPROCESSORS_ONLN) -1;
-	QUEUE_MAX = NUMBER_OF_WORKERS * TASKS_PER_THREAD;
+	//Worker Bounds, Placed Pools Leave The First Usable CPU To The Dispatcher
+	int const CPUS = placed ? topology_cpus() : sysconf(_SC_NPROCESSORS_ONLN);
+	if(thrpool.min_workers <= 0){
+		thrpool.min_workers = CPUS > 1 ? CPUS - 1 : 1;
+	}
+	if(thrpool.max_workers <= 0){
+		thrpool.max_workers = CPUS * TPOOL_GROWTH_FACTOR;
+	}
+	if(thrpool.max_workers < thrpool.min_workers){
+		thrpool.max_workers = thrpool.min_workers;
+	}
+	if(thrpool.wait_target == 0 && thrpool.max_workers > thrpool.min_workers){
+		thrpool.wait_target = TPOOL_WAIT_TARGET_US * 1000ull;
+	}
+	thrpool.idle_timeout = TPOOL_IDLE_SECONDS * 1000000000ull;
+	int const NUMBER_OF_WORKERS = thrpool.min_workers;
+	int const MAX_WORKERS = thrpool.max_workers;
 	
-	//Mutex and Semaphore Initialization
-	thrpool.queue_free_sem = QUEUE_MAX;
-	pthread_mutex_init(&thrpool.queue_free_mtx, NULL);
-	pthread_cond_init(&thrpool.queue_free_cond, NULL);
+	//Sequence Masking Requires A Power Of Two Queue, Sized For The Floor
+	QUEUE_MAX = 1;
+	while(QUEUE_MAX < NUMBER_OF_WORKERS * TASKS_PER_THREAD){
+		QUEUE_MAX <<= 1;
+	}
+	thrpool.queue_mask = QUEUE_MAX - 1;
 	
-	thrpool.queue_avail_sem = 0;
-	pthread_mutex_init(&thrpool.queue_avail_mtx, NULL);
-	pthread_cond_init(&thrpool.queue_avail_cond, NULL);
+	//Queue Entry Point And Futex Initialization
+	atomic_init(&thrpool.queue_head, 0);
+	atomic_init(&thrpool.queue_tail, 0);
+	atomic_init(&thrpool.queue_avail_seq, 0);
+	atomic_init(&thrpool.parked_workers, 0);
+	atomic_init(&thrpool.queue_free_seq, 0);
+	atomic_init(&thrpool.parked_producers, 0);
+	atomic_init(&thrpool.worker_count, NUMBER_OF_WORKERS);
+	atomic_init(&thrpool.worker_slots, NUMBER_OF_WORKERS);
+	atomic_init(&thrpool.last_growth, 0);
+	atomic_init(&thrpool.last_progress, metrics_now());
 	
-	//Queue Entry Point Initialization
-	thrpool.queue_head = 0;
+	//Spill Queue Starts Empty And Allocates On First Use
+	fifo_init(&thrpool.overflow);
+	fifo_init(&thrpool.bulk);
+	fifo_init(&thrpool.setup);
+	atomic_init(&thrpool.setup_running, 0);
+	
+	//Workers Follow The Topology Order So Neighbouring Workers Share A Node
+	thrpool.worker_cpus = NULL;
+	if(placed){
+		if((thrpool.worker_cpus = malloc(sizeof(int) * MAX_WORKERS)) == NULL){
+			perror("Could not record worker placement\n");
+			return -1;
+		}
+		for(int index = 0; index < MAX_WORKERS; index++){
+			thrpool.worker_cpus[index] = topology_cpu(index + 1);
+		}
+	}
 	
-	//Create Job Queue
-	if((thrpool.job_queue = malloc(sizeof(int) * QUEUE_MAX)) == NULL){
+	//Create Job Queue Rounded Up To Whole Cache Lines
+	size_t queue_bytes = sizeof(tpool_slot_t) * QUEUE_MAX;
+	queue_bytes = (queue_bytes + TPOOL_CACHE_LINE - 1) / TPOOL_CACHE_LINE * TPOOL_CACHE_LINE;
+	if((thrpool.job_queue = aligned_alloc(TPOOL_CACHE_LINE, queue_bytes)) == NULL){
 		perror("Could not create queue to hold jobs\n");
 		return -1;
 	}
+	for(int index = 0; index < QUEUE_MAX; index++){
+		atomic_init(&thrpool.job_queue[index].sequence, index);
+		thrpool.job_queue[index].job = 0;
+	}
 	
-	//Create Worker Threads
-	pthread_t worker_ids[NUMBER_OF_WORKERS];
+	//Create A Deque For Every Worker The Pool May Grow To
+	if(mode == TPOOL_STEALING){
+		if((thrpool.deques = aligned_alloc(TPOOL_CACHE_LINE,
+										   sizeof(tpool_deque_t) * MAX_WORKERS)) == NULL){
+			perror("Could not create worker deques\n");
+			return -1;
+		}
+		for(int index = 0; index < MAX_WORKERS; index++){
+			tpool_deque_t *deque = &thrpool.deques[index];
+			pthread_spin_init(&deque->lock, PTHREAD_PROCESS_PRIVATE);
+			deque->front = deque->back = 0;
+			atomic_init(&deque->wake_seq, 0);
+			atomic_init(&deque->parked, 0);
+			deque->node = placed ? topology_node(thrpool.worker_cpus[index]) : 0;
+			if((deque->jobs = malloc(sizeof(int) * QUEUE_MAX)) == NULL ||
+			   (deque->enqueued = malloc(sizeof(uint64_t) * QUEUE_MAX)) == NULL){
+				perror("Could not create worker deques\n");
+				return -1;
+			}
+		}
+	}
 	
+	//Create Worker Threads
 	for(int index = 0; index < NUMBER_OF_WORKERS; index++){
-		if(pthread_create(&worker_ids[index], NULL, tpool_remove_task, NULL) == -1){
-			perror("Error Creating Worker Thread\n");
+		if(start_worker(index) == -1){
 			return -1;
 		}
 	}
@@ -82,60 +525,333 @@ int tpool_init(void (*process_task) (int)){
 }
 
 
-int tpool_add_task(int newtask){
+static int start_worker(int index){
+	pthread_attr_t attr;
+	pthread_t worker_id;
+	void *(*worker_loop)(void *) = thrpool.mode == TPOOL_STEALING ? tpool_steal_task : tpool_remove_task;
+	int result;
+	
+	//Workers Are Never Joined, They Exit On Their Own When Retired
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	if(thrpool.worker_cpus != NULL && topology_pin(&attr, thrpool.worker_cpus[index]) == -1){
+		pthread_attr_destroy(&attr);
+		return -1;
+	}
+	result = pthread_create(&worker_id, &attr, worker_loop, (void *) (intptr_t) index);
+	pthread_attr_destroy(&attr);
+	if(result != 0){
+		perror("Error Creating Worker Thread\n");
+		return -1;
+	}
+	metrics_add(METRIC_WORKERS_STARTED, 1);
+	return 0;
+}
+
+
+static void grow_pool(uint64_t since, uint64_t now){
+	int live = atomic_load(&thrpool.worker_count);
+	uint64_t last = atomic_load(&thrpool.last_growth);
+	uint64_t waited = now > since ? now - since : 0;
+	
+	//Grow Only While Every Worker Is Busy, By One Worker Per Target Interval
+	if(thrpool.wait_target == 0 || waited < thrpool.wait_target || live >= thrpool.max_workers ||
+	   atomic_load(&thrpool.parked_workers) > 0 || now - last < thrpool.wait_target){
+		return;
+	}
+	if(!atomic_compare_exchange_strong(&thrpool.last_growth, &last, now) ||
+	   !atomic_compare_exchange_strong(&thrpool.worker_count, &live, live + 1)){
+		return;
+	}
+	
+	//The New Worker Owns The Next Deque, Which Thieves Now Scan As Well
+	int slots = atomic_load(&thrpool.worker_slots);
+	while(slots < live + 1 && !atomic_compare_exchange_weak(&thrpool.worker_slots, &slots, live + 1));
+	if(start_worker(live) == -1){
+		atomic_fetch_sub(&thrpool.worker_count, 1);
+	}
+}
+
+
+static int retire_worker(int worker){
+	int live = atomic_load(&thrpool.worker_count);
+	
+	//Stealing Pools Retire Only Their Highest Worker So Live Deques Stay Contiguous
+	if(live <= thrpool.min_workers || (thrpool.mode == TPOOL_STEALING && worker != live - 1)){
+		return -1;
+	}
+	if(!atomic_compare_exchange_strong(&thrpool.worker_count, &live, live - 1)){
+		return -1;
+	}
+	metrics_add(METRIC_WORKERS_RETIRED, 1);
+	return 0;
+}
+
+
+static void run_task(int job, uint64_t stamp, int setup){
+	uint64_t now = metrics_now();
 	
-	//Wait For Open Slot in Queue
-	pthread_mutex_lock(&thrpool.queue_free_mtx);
-	while (thrpool.queue_free_sem == 0){
-		pthread_cond_wait(&thrpool.queue_free_cond, &thrpool.queue_free_mtx);
+	//A Long Wait With Nobody Parked Means Every Worker Is Busy Or Blocked, Except
+	//For Setup Whose Waits Come From Its Own Bound And Would Not Shrink With More Workers
+	atomic_store_explicit(&thrpool.last_progress, now, memory_order_relaxed);
+	metrics_observe(METRIC_QUEUE_WAIT, now - stamp);
+	if(!setup){
+		grow_pool(stamp, now);
 	}
-	thrpool.queue_free_sem--;
-	pthread_mutex_unlock(&thrpool.queue_free_mtx);
+	thrpool.profunction(job);
+	if(setup){
+		atomic_fetch_sub(&thrpool.setup_running, 1);
+	}
+}
+
+
+int tpool_add_task(int newtask){
+	unsigned int affinity = newtask;
+	return tpool_add_affine_tasks(&newtask, &affinity, NULL, 1);
+}
 
-	//Acquire Lock on Queue to Add Job
-	pthread_mutex_lock(&thrpool.queue_op_mtx); 		//Lock Queue
+
+int tpool_add_affine_task(int newtask, unsigned int affinity){
+	return tpool_add_affine_tasks(&newtask, &affinity, NULL, 1);
+}
+
+
+int tpool_add_tasks(int *newtasks, int count){
+	unsigned int affinities[count];
 	
-	//Add Job to the Task Queue
-	enqueue_task(newtask);
-						
-	pthread_mutex_unlock(&thrpool.queue_op_mtx); 	//Release Queue
+	for(int index = 0; index < count; index++){
+		affinities[index] = newtasks[index];
+	}
+	return tpool_add_affine_tasks(newtasks, affinities, NULL, count);
+}
+
 
-	//Update Added Job to Size and Free Lock
-	pthread_mutex_lock(&thrpool.queue_avail_mtx);
-	thrpool.queue_avail_sem++;
-	pthread_mutex_unlock(&thrpool.queue_avail_mtx);
-	pthread_cond_signal(&thrpool.queue_avail_cond);
+int tpool_add_affine_tasks(int *newtasks, unsigned int *affinities, const tpool_lane_t *lanes, int count){
+	unsigned int seq;
+	int spins = 0, added = 0, reserved, kept = 0, laned = 0;
+	uint64_t stamp = metrics_now();	//One Clock Read Covers The Whole Batch
+	int jobs[count];
+	unsigned int keys[count];
+	char urgent[count];
 	
+	//Setup, And Bulk In Shared Mode, Leave For Their Own Lanes, The Rest Keep Their Order
+	for(int index = 0; index < count; index++){
+		tpool_lane_t lane = lanes != NULL ? lanes[index] : TPOOL_INTERACTIVE;
+		tpool_fifo_t *fifo = lane == TPOOL_SETUP ? &thrpool.setup :
+							 lane == TPOOL_BULK && thrpool.mode == TPOOL_SHARED ? &thrpool.bulk : NULL;
+		if(fifo != NULL && fifo_push(fifo, &newtasks[index], 1, stamp) == 0){
+			laned++;
+			continue;
+		}
+		jobs[kept] = newtasks[index];
+		keys[kept] = affinities[index];
+		urgent[kept++] = lane == TPOOL_INTERACTIVE;
+	}
+	newtasks = jobs;
+	affinities = keys;
+	count = kept;
+	
+	if(thrpool.mode == TPOOL_STEALING){
+		char touched[thrpool.max_workers];
+		int spilled = 0;
+		memset(touched, 0, sizeof(touched));
+		
+		while(added < count){
+			int live = atomic_load(&thrpool.worker_count);
+			int worker = affinities[added] % live;
+			
+			//Fall Back To Neighbouring Deques Only When The Owner's Is Full
+			seq = atomic_load(&thrpool.queue_free_seq);
+			int offset;
+			for(offset = 0; offset < live; offset++){
+				int target = (worker + offset) % live;
+				if(deque_push(&thrpool.deques[target], newtasks[added], stamp, urgent[added]) == 0){
+					touched[target] = 1;
+					break;
+				}
+			}
+			if(offset < live || fifo_push(&thrpool.overflow, &newtasks[added], 1, stamp) == 0){
+				spilled += offset == live;
+				added++;
+				spins = 0;
+				continue;
+			}
+			
+			//The Spill Queue Could Not Grow, So Make Sure Workers Are Awake Before Waiting
+			wake_deque_owners(touched);
+			if(spins++ < TPOOL_SPIN_COUNT){
+				cpu_relax();
+			}else{
+				wait_for_free_slot(seq);
+			}
+		}
+		wake_deque_owners(touched);
+		wake_thieves(spilled + laned);
+		grow_pool(atomic_load_explicit(&thrpool.last_progress, memory_order_relaxed), stamp);
+		return 0;
+	}
+	
+	while(added < count){
+		//Once Jobs Spill, Later Ones Follow Them So The Queue Stays First In First Out
+		seq = atomic_load(&thrpool.queue_free_seq);
+		if(atomic_load(&thrpool.overflow.pending) == 0 &&
+		   (reserved = enqueue_tasks(newtasks + added, count - added, stamp)) > 0){
+			added += reserved;
+			spins = 0;
+			wake_workers(reserved);
+			continue;
+		}
+		
+		//A Full Queue Spills Instead Of Stalling The Dispatcher
+		if(fifo_push(&thrpool.overflow, newtasks + added, count - added, stamp) == 0){
+			wake_workers(count - added);
+			added = count;
+			continue;
+		}
+		
+		//The Spill Queue Could Not Grow, Spinning Briefly Before Parking
+		if(spins++ < TPOOL_SPIN_COUNT){
+			cpu_relax();
+		}else{
+			wait_for_free_slot(seq);
+		}
+	}
+	if(laned > 0){
+		wake_workers(laned);
+	}
+	grow_pool(atomic_load_explicit(&thrpool.last_progress, memory_order_relaxed), stamp);
 	return 0;
 }
 
-static void *tpool_remove_task(){
+static void *tpool_remove_task(void *arg){
+	unsigned int picks = 0;
+	
+	(void) arg;	//Thread Entry Point, Nothing Is Passed In
 	while(1){
 		int job;  //Holds Task to Process
+		uint64_t stamp;
+		unsigned int seq;
+		int spins = 0, setup;
+		int turn = ++picks % TPOOL_FAIR_TURN == 0;
 
-		//Wait For Nonempty Queue
-		pthread_mutex_lock(&thrpool.queue_avail_mtx);
-		while (thrpool.queue_avail_sem == 0){
-			pthread_cond_wait(&thrpool.queue_avail_cond, &thrpool.queue_avail_mtx);
+		//Wait For Nonempty Queue, Spinning Briefly Before Parking
+		while(take_task(&job, &stamp, turn, &setup) == -1){
+			if(spins++ < TPOOL_SPIN_COUNT){
+				cpu_relax();
+				continue;
+			}
+			atomic_fetch_add(&thrpool.parked_workers, 1);
+			seq = atomic_load(&thrpool.queue_avail_seq);
+			if(take_task(&job, &stamp, turn, &setup) == 0){
+				atomic_fetch_sub(&thrpool.parked_workers, 1);
+				break;
+			}
+			int idle = futex_wait(&thrpool.queue_avail_seq, seq, thrpool.idle_timeout) == -1;
+			atomic_fetch_sub(&thrpool.parked_workers, 1);
+			spins = 0;
+			
+			//Idle Past The Timeout, Workers Above The Floor Leave
+			if(idle && retire_worker(-1) == 0){
+				metrics_retire();
+				pthread_exit(NULL);
+			}
 		}
-		thrpool.queue_avail_sem--;
-		pthread_mutex_unlock(&thrpool.queue_avail_mtx);
 
-		//Acquire Lock on Queue to Remove Job
-		pthread_mutex_lock(&thrpool.queue_op_mtx); 				//Lock Queue
-		if((job = dequeue_task()) < 0){
-			perror("Could not process job\n");
-		}
-		pthread_mutex_unlock(&thrpool.queue_op_mtx); 			//Release Queue
+		//Signal A Producer Blocked On A Full Queue
+		signal_free_slot();
+		
+		//Process Task With Given Function
+		run_task(job, stamp, setup);
+	}
+	pthread_exit(NULL);
+}
 
-		//Increment free count and signal:
-		pthread_mutex_lock(&thrpool.queue_free_mtx);
-		thrpool.queue_free_sem++;
-		pthread_mutex_unlock(&thrpool.queue_free_mtx);
-		pthread_cond_signal(&thrpool.queue_free_cond);
+static void *tpool_steal_task(void *arg){
+	int worker = (int) (intptr_t) arg;
+	tpool_deque_t *own = &thrpool.deques[worker];
+	unsigned int picks = 0;
+	
+	while(1){
+		int job;  //Holds Task to Process
+		uint64_t stamp;
+		unsigned int seq;
+		int spins = 0, setup;
+		int turn = ++picks % TPOOL_FAIR_TURN == 0;
+		
+		//Look Locally Then Steal, Spinning Briefly Before Parking
+		while(find_task(worker, &job, &stamp, turn, &setup) == -1){
+			if(spins++ < TPOOL_SPIN_COUNT){
+				cpu_relax();
+				continue;
+			}
+			atomic_store(&own->parked, 1);
+			atomic_fetch_add(&thrpool.parked_workers, 1);
+			seq = atomic_load(&own->wake_seq);
+			if(find_task(worker, &job, &stamp, turn, &setup) == 0){
+				atomic_store(&own->parked, 0);
+				atomic_fetch_sub(&thrpool.parked_workers, 1);
+				break;
+			}
+			int idle = futex_wait(&own->wake_seq, seq, thrpool.idle_timeout) == -1;
+			atomic_store(&own->parked, 0);
+			atomic_fetch_sub(&thrpool.parked_workers, 1);
+			spins = 0;
+			
+			//A Retired Owner Finishes What Already Reached Its Deque, Thieves Take Anything Later
+			if(idle && retire_worker(worker) == 0){
+				while(deque_pop_front(own, &job, &stamp) == 0){
+					signal_free_slot();
+					thrpool.profunction(job);
+				}
+				metrics_retire();
+				pthread_exit(NULL);
+			}
+		}
+		
+		//Signal A Producer Blocked On Full Deques
+		signal_free_slot();
 		
 		//Process Task With Given Function
-		thrpool.profunction(job);
+		run_task(job, stamp, setup);
 	}
 	pthread_exit(NULL);
-}
\ No newline at end of file
+}
+
+
+uint64_t tpool_queue_depth(){
+	uint64_t depth = atomic_load(&thrpool.overflow.pending) + atomic_load(&thrpool.bulk.pending) +
+					 atomic_load(&thrpool.setup.pending);
+	
+	//Pool Never Started, As In The Event Loop And io_uring Modes
+	if(thrpool.job_queue == NULL){
+		return 0;
+	}
+	if(thrpool.mode == TPOOL_STEALING){
+		int slots = atomic_load(&thrpool.worker_slots);
+		for(int index = 0; thrpool.deques != NULL && index < slots; index++){
+			tpool_deque_t *deque = &thrpool.deques[index];
+			pthread_spin_lock(&deque->lock);
+			depth += deque->back - deque->front;
+			pthread_spin_unlock(&deque->lock);
+		}
+		return depth;
+	}
+	return depth + atomic_load(&thrpool.queue_head) - atomic_load(&thrpool.queue_tail);
+}
+
+
+int tpool_worker_on(int cpu){
+	int neighbour = -1;
+	int live = atomic_load(&thrpool.worker_count);
+	
+	//The Worker Pinned To The CPU, Else Any Worker On The Same Node
+	for(int index = 0; thrpool.worker_cpus != NULL && index < live; index++){
+		if(thrpool.worker_cpus[index] == cpu){
+			return index;
+		}
+		if(neighbour == -1 && topology_node(thrpool.worker_cpus[index]) == topology_node(cpu)){
+			neighbour = index;
+		}
+	}
+	return neighbour;
+}
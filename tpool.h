@@ -1,34 +1,111 @@
 #ifndef TPOOL_H
 #define TPOOL_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
 #define TASKS_PER_THREAD  5
+#define TPOOL_SPIN_COUNT  256
+#define TPOOL_CACHE_LINE  64
+#define TPOOL_GROWTH_FACTOR 4	//Default Worker Ceiling Per CPU, For Workers Blocked In fork
+#define TPOOL_WAIT_TARGET_US 2000	//Queue Wait That Adds A Worker
+#define TPOOL_IDLE_SECONDS 5	//Parked This Long, Workers Above The Floor Retire
+#define TPOOL_FIFO_INITIAL 256
+#define TPOOL_SETUP_SHARE 4	//At Most One Live Worker In This Many Runs Session Setup
+#define TPOOL_FAIR_TURN 8	//Every Eighth Pick Serves Setup And Bulk First So They Never Starve
+
 //Function Pointer Task
 typedef void (*Task)(int job);
 
+//Scheduling Policy Chosen At Initialization
+typedef enum {TPOOL_SHARED, TPOOL_STEALING} tpool_mode_t;
+
+//Priority Classes, Interactive Jobs Run Ahead Of Bulk And Setup Has Its Own Bounded Lane
+typedef enum {TPOOL_INTERACTIVE, TPOOL_BULK, TPOOL_SETUP} tpool_lane_t;
+
+//Sequence Numbered Queue Slot Declaration
+typedef struct tpool_slot {
+	atomic_size_t sequence;
+	int job;
+	uint64_t enqueued;	//Nanoseconds, For Queue Wait Metrics
+} tpool_slot_t;
+
+//Spilled Job Declaration
+typedef struct tpool_entry {
+	int job;
+	uint64_t enqueued;
+} tpool_entry_t;
+
+//Unbounded Mutex Guarded Queue For Spilled Jobs And The Bulk And Setup Lanes
+typedef struct tpool_fifo {
+	pthread_mutex_t lock;
+	tpool_entry_t *entries;
+	size_t capacity;	//Power Of Two, Doubled When Full
+	size_t front;
+	size_t count;
+	atomic_size_t pending;	//Read Without The Lock To Skip An Empty Queue
+} tpool_fifo_t;
+
+//Per Worker Deque Declaration, Owner Pops The Front And Thieves Take The Back
+typedef struct tpool_deque {
+	_Alignas(TPOOL_CACHE_LINE) pthread_spinlock_t lock;
+	int *jobs;
+	uint64_t *enqueued;
+	size_t front;
+	size_t back;
+	atomic_uint wake_seq;
+	atomic_int parked;
+	int node;	//NUMA Node Of The Owner, Thieves Try Their Own Node First
+} tpool_deque_t;
+
 //Thread Pool Struct Declaration
 typedef struct tpool {
-	int queue_head;
-	int queue_tail;
-	int *job_queue;
+	tpool_mode_t mode;
+	int min_workers;
+	int max_workers;
+	uint64_t wait_target;	//Nanoseconds, Zero Keeps The Pool At Its Floor
+	uint64_t idle_timeout;	//Nanoseconds
+	tpool_slot_t *job_queue;
+	tpool_deque_t *deques;
+	size_t queue_mask;
 	Task profunction;
+	int *worker_cpus;	//CPU Each Worker Is Pinned To, NULL When Unplaced
+	tpool_fifo_t overflow;	//Interactive Jobs That Found The Bounded Queues Full, So Producers Never Block
+	tpool_fifo_t bulk;		//Shared Mode Only, Stealing Deques Keep Bulk Jobs At Their Back
+	tpool_fifo_t setup;
+	atomic_int setup_running;
 	
-	pthread_mutex_t queue_op_mtx;
-
-	int queue_free_sem;
-	pthread_mutex_t queue_free_mtx;
-	pthread_cond_t queue_free_cond;
+	//Live Workers Own Deques Below worker_count, Thieves Scan Every Deque Ever Owned
+	_Alignas(TPOOL_CACHE_LINE) atomic_int worker_count;
+	atomic_int worker_slots;
+	atomic_uint_least64_t last_growth;
+	_Alignas(TPOOL_CACHE_LINE) atomic_uint_least64_t last_progress;	//Nanoseconds Of The Latest Dequeue
+	
+	//Producers And Consumers Advance On Separate Cache Lines
+	_Alignas(TPOOL_CACHE_LINE) atomic_size_t queue_head;
+	_Alignas(TPOOL_CACHE_LINE) atomic_size_t queue_tail;
 	
-	int queue_avail_sem;
-	pthread_mutex_t queue_avail_mtx;
-	pthread_cond_t queue_avail_cond;
+	//Futex Words Bumped On Every Enqueue And Dequeue
+	_Alignas(TPOOL_CACHE_LINE) atomic_uint queue_avail_seq;
+	atomic_int parked_workers;
+	_Alignas(TPOOL_CACHE_LINE) atomic_uint queue_free_seq;
+	atomic_int parked_producers;
 	
 }tpool_t;
 
 //Function Prototypes
-int tpool_init(void (*process_task) (int));
+void tpool_set_elastic(int min_workers, int max_workers, uint64_t wait_target);
+int tpool_init(void (*process_task) (int), tpool_mode_t mode, int placed);
 int tpool_add_task(int newtask);
+int tpool_add_affine_task(int newtask, unsigned int affinity);
+int tpool_add_tasks(int *newtasks, int count);
+int tpool_add_affine_tasks(int *newtasks, unsigned int *affinities, const tpool_lane_t *lanes, int count);
+uint64_t tpool_queue_depth();
+int tpool_worker_on(int cpu);
 
 //Test Function Prototypes
 void print_queue();
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,242 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "uring.h"
+
+//Local Function Prototypes
+static int map_rings(Uring *ring, struct io_uring_params *params);
+static int register_buffers(Uring *ring, unsigned buf_count, unsigned buf_size);
+static void prep_entry(struct io_uring_sqe *sqe, int opcode, int source_fd, uint64_t data);
+
+
+int uring_init(Uring *ring, unsigned entries, unsigned buf_count, unsigned buf_size){
+	struct io_uring_params params;
+
+	//Multishot Accept Can Post Many Completions Per Submission So Size The CQ Up
+	memset(&params, 0, sizeof(params));
+	params.flags = IORING_SETUP_CQSIZE;
+	params.cq_entries = entries * 4;
+
+	if((ring->ring_fd = syscall(SYS_io_uring_setup, entries, &params)) == -1){
+		perror("\nIn Function (uring_init), Error Creating The io_uring Instance."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	if(map_rings(ring, &params) == -1 || register_buffers(ring, buf_count, buf_size) == -1){
+		close(ring->ring_fd);
+		return -1;
+	}
+	ring->sq_queued = 0;
+	return 0;
+}
+
+
+static int map_rings(Uring *ring, struct io_uring_params *params){
+	size_t sq_size = params->sq_off.array + params->sq_entries * sizeof(unsigned);
+	size_t cq_size = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+	char *sq_ptr, *cq_ptr;
+
+	//Newer Kernels Share One Mapping Between Both Rings
+	if(params->features & IORING_FEAT_SINGLE_MMAP){
+		sq_size = cq_size = sq_size > cq_size ? sq_size : cq_size;
+	}
+	sq_ptr = mmap(NULL, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+				  ring->ring_fd, IORING_OFF_SQ_RING);
+	if(sq_ptr == MAP_FAILED){
+		perror("\nIn Function (map_rings), Error Mapping The Submission Ring."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+	cq_ptr = sq_ptr;
+	if(!(params->features & IORING_FEAT_SINGLE_MMAP)){
+		cq_ptr = mmap(NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+					  ring->ring_fd, IORING_OFF_CQ_RING);
+		if(cq_ptr == MAP_FAILED){
+			perror("\nIn Function (map_rings), Error Mapping The Completion Ring."
+				   " NOTE: This Error Exits The Corresponding Function.");
+			return -1;
+		}
+	}
+	ring->sqes = mmap(NULL, params->sq_entries * sizeof(struct io_uring_sqe),
+					  PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+					  ring->ring_fd, IORING_OFF_SQES);
+	if(ring->sqes == MAP_FAILED){
+		perror("\nIn Function (map_rings), Error Mapping The Submission Entries."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+
+	ring->sq_head = (unsigned *) (sq_ptr + params->sq_off.head);
+	ring->sq_tail = (unsigned *) (sq_ptr + params->sq_off.tail);
+	ring->sq_array = (unsigned *) (sq_ptr + params->sq_off.array);
+	ring->sq_mask = *(unsigned *) (sq_ptr + params->sq_off.ring_mask);
+	ring->cq_head = (unsigned *) (cq_ptr + params->cq_off.head);
+	ring->cq_tail = (unsigned *) (cq_ptr + params->cq_off.tail);
+	ring->cq_mask = *(unsigned *) (cq_ptr + params->cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *) (cq_ptr + params->cq_off.cqes);
+	return 0;
+}
+
+
+static int register_buffers(Uring *ring, unsigned buf_count, unsigned buf_size){
+	struct io_uring_buf_reg reg;
+
+	//The Kernel Indexes The Buffer Ring With A Mask
+	ring->buf_count = 1;
+	while(ring->buf_count < buf_count){
+		ring->buf_count <<= 1;
+	}
+	ring->buf_size = buf_size;
+	ring->buf_tail = 0;
+
+	ring->buf_ring = mmap(NULL, ring->buf_count * sizeof(struct io_uring_buf),
+						  PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(ring->buf_ring == MAP_FAILED || (ring->buf_base = malloc((size_t) ring->buf_count * buf_size)) == NULL){
+		perror("\nIn Function (register_buffers), Error Allocating Provided Read Buffers."
+			   " NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+
+	memset(&reg, 0, sizeof(reg));
+	reg.ring_addr = (uint64_t) (uintptr_t) ring->buf_ring;
+	reg.ring_entries = ring->buf_count;
+	reg.bgid = URING_BUFFER_GROUP;
+	if(syscall(SYS_io_uring_register, ring->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) == -1){
+		perror("\nIn Function (register_buffers), Error Registering The Provided Buffer"
+			   " Ring. NOTE: This Error Exits The Corresponding Function.");
+		return -1;
+	}
+
+	//Hand Every Buffer To The Kernel Up Front
+	for(unsigned bid = 0; bid < ring->buf_count; bid++){
+		uring_recycle(ring, bid);
+	}
+	return 0;
+}
+
+
+struct io_uring_sqe *uring_get_sqe(Uring *ring){
+	unsigned tail = *ring->sq_tail;
+
+	//A Full Submission Ring Is Flushed Before Another Entry Is Handed Out
+	while(tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) > ring->sq_mask){
+		if(uring_submit(ring, 0) == -1){
+			return NULL;
+		}
+	}
+
+	struct io_uring_sqe *sqe = &ring->sqes[tail & ring->sq_mask];
+	memset(sqe, 0, sizeof(*sqe));
+	ring->sq_array[tail & ring->sq_mask] = tail & ring->sq_mask;
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	ring->sq_queued++;
+	return sqe;
+}
+
+
+int uring_submit(Uring *ring, unsigned wait_for){
+	int submitted;
+	unsigned flags = wait_for > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+	//One System Call Submits The Whole Batch And Optionally Waits
+	while((submitted = syscall(SYS_io_uring_enter, ring->ring_fd, ring->sq_queued,
+							   wait_for, flags, NULL, 0)) == -1){
+		if(errno != EINTR && errno != EAGAIN && errno != EBUSY){
+			perror("\nIn Function (uring_submit), Error Entering The io_uring Instance."
+				   " NOTE: This Error Exits The Corresponding Function.");
+			return -1;
+		}
+
+		//Interrupted Or Backed Up Rings Still Have Completions To Reap
+		if(errno != EINTR){
+			return 0;
+		}
+	}
+	ring->sq_queued -= submitted;
+	return submitted;
+}
+
+
+struct io_uring_cqe *uring_peek(Uring *ring){
+	unsigned head = *ring->cq_head;
+
+	if(head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)){
+		return NULL;
+	}
+	return &ring->cqes[head & ring->cq_mask];
+}
+
+
+void uring_seen(Uring *ring){
+	__atomic_store_n(ring->cq_head, *ring->cq_head + 1, __ATOMIC_RELEASE);
+}
+
+
+char *uring_buffer(Uring *ring, unsigned bid){
+	return ring->buf_base + (size_t) bid * ring->buf_size;
+}
+
+
+void uring_recycle(Uring *ring, unsigned bid){
+	struct io_uring_buf *buf = &ring->buf_ring->bufs[ring->buf_tail & (ring->buf_count - 1)];
+
+	//Publish The Buffer Back To The Group Reads Select From
+	buf->addr = (uint64_t) (uintptr_t) uring_buffer(ring, bid);
+	buf->len = ring->buf_size;
+	buf->bid = bid;
+	ring->buf_tail++;
+	__atomic_store_n(&ring->buf_ring->tail, ring->buf_tail, __ATOMIC_RELEASE);
+}
+
+
+static void prep_entry(struct io_uring_sqe *sqe, int opcode, int source_fd, uint64_t data){
+	sqe->opcode = opcode;
+	sqe->fd = source_fd;
+	sqe->user_data = data;
+}
+
+
+void uring_prep_accept(struct io_uring_sqe *sqe, int server_fd, int flags, uint64_t data){
+	//One Submission Keeps Posting A Completion Per Accepted Connection
+	prep_entry(sqe, IORING_OP_ACCEPT, server_fd, data);
+	sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+	sqe->accept_flags = flags;
+}
+
+
+void uring_prep_poll(struct io_uring_sqe *sqe, int source_fd, uint32_t events, uint64_t data){
+	prep_entry(sqe, IORING_OP_POLL_ADD, source_fd, data);
+	sqe->poll32_events = events;
+}
+
+
+void uring_prep_read(struct io_uring_sqe *sqe, int source_fd, unsigned length, uint64_t data){
+	//The Kernel Picks The Buffer When Data Arrives, Not At Submission
+	prep_entry(sqe, IORING_OP_READ, source_fd, data);
+	sqe->off = (uint64_t) -1;
+	sqe->len = length;
+	sqe->flags = IOSQE_BUFFER_SELECT;
+	sqe->buf_group = URING_BUFFER_GROUP;
+}
+
+
+void uring_prep_write(struct io_uring_sqe *sqe, int dest_fd, const void *buffer,
+					  unsigned length, uint64_t data){
+	prep_entry(sqe, IORING_OP_WRITE, dest_fd, data);
+	sqe->off = (uint64_t) -1;
+	sqe->addr = (uint64_t) (uintptr_t) buffer;
+	sqe->len = length;
+}
+
+
+void uring_prep_cancel(struct io_uring_sqe *sqe, int source_fd, uint64_t data){
+	//Cancel Every Request Still Outstanding Against The Descriptor
+	prep_entry(sqe, IORING_OP_ASYNC_CANCEL, source_fd, data);
+	sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+}
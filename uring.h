@@ -0,0 +1,47 @@
+#ifndef URING_H
+#define URING_H
+
+#include <stdint.h>
+#include <linux/io_uring.h>
+
+#define URING_ENTRIES 1024
+#define URING_BUFFER_GROUP 0
+
+//Submission And Completion Rings Mapped From One io_uring Instance
+typedef struct uring_t {
+	int ring_fd;
+	unsigned *sq_head;
+	unsigned *sq_tail;
+	unsigned *sq_array;
+	unsigned sq_mask;
+	unsigned sq_queued;		//Entries Filled In But Not Yet Submitted
+	struct io_uring_sqe *sqes;
+	unsigned *cq_head;
+	unsigned *cq_tail;
+	unsigned cq_mask;
+	struct io_uring_cqe *cqes;
+	struct io_uring_buf_ring *buf_ring;	//Provided Buffers Reads Select From
+	char *buf_base;
+	unsigned buf_count;		//Always A Power Of Two
+	unsigned buf_size;
+	uint16_t buf_tail;
+} Uring;
+
+//Function Prototypes
+int uring_init(Uring *ring, unsigned entries, unsigned buf_count, unsigned buf_size);
+struct io_uring_sqe *uring_get_sqe(Uring *ring);
+int uring_submit(Uring *ring, unsigned wait_for);
+struct io_uring_cqe *uring_peek(Uring *ring);
+void uring_seen(Uring *ring);
+char *uring_buffer(Uring *ring, unsigned bid);
+void uring_recycle(Uring *ring, unsigned bid);
+
+//Submission Entry Preparation
+void uring_prep_accept(struct io_uring_sqe *sqe, int server_fd, int flags, uint64_t data);
+void uring_prep_poll(struct io_uring_sqe *sqe, int source_fd, uint32_t events, uint64_t data);
+void uring_prep_read(struct io_uring_sqe *sqe, int source_fd, unsigned length, uint64_t data);
+void uring_prep_write(struct io_uring_sqe *sqe, int dest_fd, const void *buffer,
+					  unsigned length, uint64_t data);
+void uring_prep_cancel(struct io_uring_sqe *sqe, int source_fd, uint64_t data);
+
+#endif